@@ -0,0 +1,34 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define ASSET_ALPHA 0x01
+
+// Images are stored as top-down ARGB8888 pixels (width * 4 bytes per
+// row); anything else, like the font, is stored as the original file.
+// Both are deflated.
+struct Asset {
+  const char *name;
+  int width;
+  int height;
+  uint32_t flags;
+  size_t size;
+  const unsigned char *data;
+  size_t packedSize;
+};
+
+class Assets {
+public:
+  static const Asset *find(const char *name);
+
+  static bool inflate(const Asset *asset, std::vector<uint8_t> &out);
+
+  static const Asset table[];
+
+  static const int count;
+};
+
+#endif
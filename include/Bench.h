@@ -0,0 +1,38 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "Options.h"
+#include "Position.h"
+
+struct BenchPosition {
+  Position position;
+  int color;
+};
+
+// Shared setup and timing for the benchmarks and latency stats, so they
+// all search the same positions and measure the same way.
+class Bench {
+public:
+  // The first count random positions, seeded 1, 2, ..., whose side to
+  // move has a legal move.
+  static std::vector<BenchPosition> positions(int count);
+
+  // Single-threaded searches without the opening book or the solved
+  // cache, so results never depend on earlier runs.
+  static Options searchOptions(const Options &options);
+
+  static int64_t microsSince(std::chrono::steady_clock::time_point start);
+
+  // Median and 99th percentile of v; both 0 when v is empty.
+  static void percentiles(std::vector<int64_t> v, int64_t *p50, int64_t *p99);
+
+  // --bench-eval: searches with every leaf fully evaluated, then through
+  // the evaluation cache and lazy evaluation.
+  static int evaluation(const Options &options, int searches);
+};
+
+#endif
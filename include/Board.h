@@ -3,30 +3,32 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <vector>
 #include "Move.h"
-
-#define SIZE 8
-
-#define DARK -1
-#define EMPTY 0
-#define LIGHT 1
+#include "Position.h"
 
 #define EARLY 1
 #define MIDDLE 2
 #define LATE 3
 
-class Board {
+template<int N>
+class BasicBoard {
 public:
-  Board();
+  BasicBoard();
+
+  BasicBoard(BasicBoard const &board);
 
-  Board(Board const &board);
+  explicit BasicBoard(const BasicPosition<N> &position);
 
-  ~Board();
+  ~BasicBoard();
 
   int getMovesScore(int color);
 
+  // As above for a position, staged by its disc count.
+  static int getMovesScore(const BasicPosition<N> &position, int color);
+
   bool legalMove(int col, int row, int color);
 
   std::vector<Move> legalMoves(int color);
@@ -41,9 +43,18 @@ public:
 
   int stage();
 
-  static const int earlyVals[SIZE][SIZE];
-  static const int middleVals[SIZE][SIZE];
-  static const int lateVals[SIZE][SIZE];
+  BasicPosition<N> position() const;
+
+  static bool loadWeights(const char *path);
+
+  static void resetWeights();
+
+  static int earlyVals[N][N];
+  static int middleVals[N][N];
+  static int lateVals[N][N];
+
+  static int earlyStage;
+  static int middleStage;
 
   static const short neighbors[8][2];
 
@@ -51,7 +62,13 @@ public:
   Move *lastMove;
 
 private:
-  int moves[SIZE][SIZE]{};
+  int moves[N][N]{};
 };
 
+extern template class BasicBoard<6>;
+extern template class BasicBoard<8>;
+extern template class BasicBoard<10>;
+
+typedef BasicBoard<SIZE> Board;
+
 #endif
@@ -0,0 +1,35 @@
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "GameRecord.h"
+#include "Move.h"
+#include "Position.h"
+
+#define BOOK "res/book.rgr"
+#define BOOK_PLIES 20
+
+struct BookMove {
+  uint8_t square;
+  uint32_t games;
+  int32_t score;
+};
+
+class Book {
+public:
+  bool load(const char *path);
+
+  void add(const RecordView &record);
+
+  Move probe(const Position &position, int color) const;
+
+  size_t size() const;
+
+private:
+  std::unordered_map<uint64_t, std::vector<BookMove>> entries;
+};
+
+#endif
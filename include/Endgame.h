@@ -0,0 +1,46 @@
+#ifndef ENDGAME_H
+#define ENDGAME_H
+
+#include "Position.h"
+
+class SolvedCache;
+
+#define ENDGAME_EMPTIES 10
+#define STABILITY_EMPTIES 5
+#define EXACT_SCORE 10000000
+
+template<int N>
+class BasicEndgame {
+public:
+  static int solve(const BasicPosition<N> &position, int color, int alpha, int beta);
+
+  // As above, but positions with at least CACHE_MIN_EMPTIES empties are
+  // looked up in and written to cache first.
+  static int solve(const BasicPosition<N> &position, int color, int alpha, int beta, SolvedCache *cache);
+
+  static int finalScore(const BasicPosition<N> &position, int color);
+
+  static int stabilityBound(const BasicPosition<N> &position, int color);
+
+  // The steps of solve() that BasicSearch's coroutine solve shares.
+  // cutoff settles a node without trying a move where it can: the final
+  // score once neither side can move, or a stability bound outside
+  // (alpha, beta). moves is color's legal moves; when it is empty and
+  // cutoff returns false, color passes.
+  static bool cutoff(const BasicPosition<N> &position, int color, typename BasicPosition<N>::Mask moves, int alpha, int beta, int *score);
+
+  // The cache lookup and write around a solve. Both do nothing without a
+  // cache or below CACHE_MIN_EMPTIES; probeCache narrows (alpha, beta) to
+  // what is known and returns true with *score when that settles it.
+  static bool probeCache(SolvedCache *cache, const BasicPosition<N> &position, int color, int &alpha, int &beta, int *score);
+
+  static void storeCache(SolvedCache *cache, const BasicPosition<N> &position, int color, int alpha, int beta, int score);
+};
+
+extern template class BasicEndgame<6>;
+extern template class BasicEndgame<8>;
+extern template class BasicEndgame<10>;
+
+typedef BasicEndgame<SIZE> Endgame;
+
+#endif
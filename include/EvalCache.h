@@ -0,0 +1,30 @@
+#ifndef EVAL_CACHE_H
+#define EVAL_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "TranspositionTable.h"
+
+#define EVAL_CACHE_SLOTS (1 << 16)
+
+// Direct-mapped leaf evaluation cache: a store always replaces whatever
+// the slot held. Slots use the TTSlot layout, so every search thread can
+// share one cache without locks.
+class EvalCache {
+public:
+  explicit EvalCache(size_t slots = EVAL_CACHE_SLOTS);
+
+  bool probe(uint64_t key, int *value) const;
+
+  void store(uint64_t key, int value);
+
+  void clear();
+
+private:
+  std::unique_ptr<TTSlot[]> slots;
+  uint64_t mask{};
+};
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <chrono>
 #include <ctime>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <random>
 #include <sstream>
 #include <thread>
@@ -11,13 +14,18 @@
 #include <SDL2_gfxPrimitives.h>
 #include <SDL_ttf.h>
 
+#include "Assets.h"
 #include "Board.h"
+#include "Book.h"
+#include "GameRecord.h"
 #include "Move.h"
-
-#define DEPTH 7
+#include "Options.h"
+#include "Search.h"
+#include "SolvedCache.h"
+#include "TranspositionTable.h"
 
 #define SCREEN_W  626
-#define SCREEN_H 626
+#define SCREEN_H (SCREEN_W + FOOTER)
 #define BOARD_HW  600
 #define LABEL 24
 #define DISC (BOARD_HW / SIZE)
@@ -26,8 +34,11 @@
 #define BTN_W 120
 #define BTN_H 40
 #define BTN_SPACE 20
+#define FOOTER (BTN_H + BTN_SPACE)
 
-#define FONT "res/font/LiberationSerif-Bold.ttf"
+#define FONT "font"
+#define BACKGROUND "bg"
+#define RECORDS "games.rgr"
 
 enum Buttons {
   BtnOptions, BtnQuit, BtnYes, BtnNo,
@@ -42,9 +53,14 @@ enum Menus {
   MenuNone, MenuOptions, MenuGameOver
 };
 
+enum OptionRows {
+  OptTime, OptDepth, OptThreads, OptHash, OptBook, OptWeights, OptDone,
+  OptCount
+};
+
 class Game {
 public:
-  explicit Game(const char *title);
+  Game(const char *title, const Options &options);
   ~Game();
 
   bool isRunning();
@@ -73,8 +89,12 @@ public:
 
   void drawMenu();
 
+  void drawFooter();
+
   void newGame();
 
+  void saveRecord();
+
   void handleClick(SDL_MouseButtonEvent *event);
 
   bool isPlayerTurn();
@@ -85,18 +105,24 @@ public:
 
   bool insideRect(SDL_Rect rect, int x, int y);
 
-  static int evaluate(Board *board, int color);
-
-  static int otherColor(int color);
+  void handleOptionsClick();
 
-  static int minimax(Board *board, int depth, int alpha, int beta, bool maximizingPlayer);
+  std::string optionLabel(int option);
 
-  static int colorScoreWeight(Board *board);
+  void cycleOption(int option);
 
-  static int mobilityScoreWeight(Board *board);
+  void applyOptions();
 
   Move getAiMove();
 
+  bool decodeAssets();
+
+  SDL_Texture *createTexture(const Asset *asset, std::vector<uint8_t> &pixels);
+
+  SDL_Texture *buttonTexture(int button);
+
+  TTF_Font *openFont(int size);
+
   void writeText(const char *text, int x, int y, TTF_Font *font);
 
   static void aiThread(Game *game);
@@ -104,13 +130,24 @@ public:
   std::string letters[8] = {"a", "b", "c", "d", "e", "f", "g", "h"};
   std::string numbers[8] = {"1", "2", "3", "4", "5", "6", "7", "8"};
 
+  static const char *buttonAssets[BtnCount];
+
+  std::chrono::steady_clock::time_point firstFrame;
+
 private:
   bool running = false;
   SDL_Window *window{};
   SDL_Renderer *renderer{};
-  SDL_Surface *bgSurface;
-  SDL_Texture *bgTexture;
+  SDL_Texture *bgTexture{};
   Board *board{};
+  GameRecord record;
+
+  Options options;
+  std::string weightsPath;
+  std::string weightsLoaded;
+  TranspositionTable table;
+  std::unique_ptr<SolvedCache> cache;
+  Book book;
 
   int mouseX{};
   int mouseY{};
@@ -118,13 +155,14 @@ private:
   int turn{};
   int currentMenu = MenuNone;
 
-  SDL_Texture *btnTextures[BtnCount];
-  SDL_Rect btnRects[BtnCount];
+  SDL_Texture *btnTextures[BtnCount]{};
+  SDL_Rect btnRects[BtnCount]{};
+  SDL_Rect optionRects[OptCount];
 
-  SDL_Surface *btnOptionsSurface;
-  SDL_Surface *btnQuitSurface;
-  SDL_Surface *btnYesSurface;
-  SDL_Surface *btnNoSurface;
+  std::future<bool> decoded;
+  std::vector<uint8_t> bgPixels;
+  std::vector<uint8_t> btnPixels[BtnCount];
+  std::vector<uint8_t> fontData;
 
   TTF_Font *font15;
   TTF_Font *font21;
@@ -0,0 +1,132 @@
+#ifndef GAME_RECORD_H
+#define GAME_RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#include "Move.h"
+#include "Position.h"
+
+// On-disk layout (little-endian), records packed back to back:
+//   RecordHeader (8 bytes)
+//   moveCount square bytes (row * SIZE + col), padded to an even length
+//   moveCount int16 evaluations, only when RECORD_EVALS is set
+// Passes are not stored; a side with no legal move passes by rule.
+// Iteration ends at the first record with a bad header or a square
+// outside the board, as it would at a truncated one.
+
+#define RECORD_MAGIC 0x5652
+#define RECORD_VERSION 1
+#define RECORD_EVALS 0x01
+
+struct RecordHeader {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t flags;
+  uint16_t moveCount;
+  int16_t result;
+};
+
+static_assert(sizeof(RecordHeader) == 8, "RecordHeader must stay 8 bytes");
+
+class RecordView {
+public:
+  RecordView(const RecordHeader *header, const uint8_t *moves, const int16_t *evals);
+
+  int moveCount() const;
+
+  bool hasEvals() const;
+
+  Move move(int ply) const;
+
+  int eval(int ply) const;
+
+  // Replays up to ply moves, stopping early at the first illegal one.
+  Position positionAt(int ply, int *color) const;
+
+  static size_t size(const RecordHeader &header);
+
+  const RecordHeader *header;
+  const uint8_t *moves;
+  const int16_t *evals;
+};
+
+class GameRecord {
+public:
+  GameRecord();
+
+  void clear();
+
+  void addMove(const Move &move);
+
+  void addMove(const Move &move, int eval);
+
+  void setResult(int result);
+
+  void write(std::ostream &out) const;
+
+  RecordView view() const;
+
+private:
+  RecordHeader header;
+  std::vector<uint8_t> moves;
+  std::vector<int16_t> evals;
+};
+
+class GameRecordWriter {
+public:
+  explicit GameRecordWriter(const char *path);
+
+  bool isOpen() const;
+
+  void write(const GameRecord &record);
+
+  void flush();
+
+private:
+  std::ofstream out;
+};
+
+class GameRecordFile {
+public:
+  class Iterator {
+  public:
+    Iterator(const uint8_t *pos, const uint8_t *end);
+
+    RecordView operator*() const;
+
+    Iterator &operator++();
+
+    bool operator!=(const Iterator &other) const;
+
+  private:
+    void validate();
+
+    const uint8_t *pos;
+    const uint8_t *end;
+  };
+
+  explicit GameRecordFile(const char *path);
+
+  ~GameRecordFile();
+
+  GameRecordFile(const GameRecordFile &) = delete;
+
+  GameRecordFile &operator=(const GameRecordFile &) = delete;
+
+  bool isOpen() const;
+
+  Iterator begin() const;
+
+  Iterator end() const;
+
+private:
+  const uint8_t *data = nullptr;
+  size_t length = 0;
+  std::vector<uint8_t> buffer;
+  bool mapped = false;
+};
+
+#endif
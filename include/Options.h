@@ -0,0 +1,36 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <string>
+
+#include "SolvedCache.h"
+#include "TranspositionTable.h"
+
+#define DEPTH 7
+#define CONFIG "reversi.cfg"
+
+class Options {
+public:
+  bool set(const std::string &name, const std::string &value);
+
+  std::string get(const std::string &name) const;
+
+  bool load(const char *path);
+
+  void parseArgs(int argc, char *argv[]);
+
+  std::string dataPath(const char *name) const;
+
+  int timePerMove = 0;
+  int depth = DEPTH;
+  int threads = 1;
+  int hashSize = HASH_MB;
+  bool useBook = true;
+  std::string evalWeights;
+  std::string cachePath;
+  std::string baseDir;
+
+  static const char *names[];
+};
+
+#endif
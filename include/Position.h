@@ -0,0 +1,96 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#define SIZE 8
+
+#define DARK -1
+#define EMPTY 0
+#define LIGHT 1
+
+#define SYMMETRIES 8
+#define SYM_VERTICAL 1
+#define SYM_HORIZONTAL 2
+#define SYM_DIAGONAL 4
+
+template<int N>
+class BasicPosition {
+public:
+  static_assert(N >= 4 && N % 2 == 0 && N * N <= 128, "unsupported board size");
+
+  typedef typename std::conditional<(N * N <= 64), uint64_t, unsigned __int128>::type Mask;
+
+  BasicPosition();
+  BasicPosition(Mask dark, Mask light);
+
+  static BasicPosition initial();
+
+  // Plays up to plies random legal moves from the initial position; color
+  // receives the side to move (the one that has a move, if either does).
+  static BasicPosition random(unsigned seed, int plies, int *color);
+
+  static int square(int col, int row);
+
+  static Mask bit(int square) { return (Mask) 1 << square; }
+
+  static int bitCount(uint64_t mask) { return __builtin_popcountll(mask); }
+
+  static int bitCount(unsigned __int128 mask) { return bitCount((uint64_t) mask) + bitCount((uint64_t) (mask >> 64)); }
+
+  static int firstSquare(uint64_t mask) { return __builtin_ctzll(mask); }
+
+  static int firstSquare(unsigned __int128 mask) {
+    auto low = (uint64_t) mask;
+    return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll((uint64_t) (mask >> 64));
+  }
+
+  int getColor(int col, int row) const;
+
+  int count(int color) const;
+
+  int empties() const;
+
+  Mask discs(int color) const;
+
+  Mask legalMoves(int color) const;
+
+  Mask flips(int square, int color) const;
+
+  void play(int square, int color);
+
+  Mask stable(int color) const;
+
+  static Mask transform(Mask mask, int symmetry);
+
+  static int transformSquare(int square, int symmetry);
+
+  static int inverse(int symmetry);
+
+  BasicPosition transformed(int symmetry) const;
+
+  BasicPosition canonical(int *symmetry) const;
+
+  uint64_t hash() const;
+
+  uint64_t key(int color, int *symmetry = nullptr) const;
+
+  bool operator==(const BasicPosition &other) const;
+
+  bool operator!=(const BasicPosition &other) const;
+
+  Mask dark;
+  Mask light;
+};
+
+extern template class BasicPosition<6>;
+extern template class BasicPosition<8>;
+extern template class BasicPosition<10>;
+
+typedef BasicPosition<SIZE> Position;
+
+static_assert(sizeof(Position) == 16, "Position must stay two 64-bit masks");
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <string>
+
+#include "Options.h"
+
+#define PROFILE_JSON "profile.json"
+
+enum ProfilePoint {
+  ProfileLegalMoves,
+  ProfileFlipPieces,
+  ProfileEvaluate,
+  ProfileSearch,
+  ProfilePoints
+};
+
+enum ProfileCounter {
+  CounterCycles,
+  CounterInstructions,
+  CounterBranchMisses,
+  CounterL1Misses,
+  CounterLLCMisses,
+  Counters
+};
+
+struct ProfileSample {
+  uint64_t nanos;
+  uint64_t counts[Counters];
+  long guards;
+};
+
+struct ProfileTotals {
+  long calls;
+  double nanos;
+  double counts[Counters];
+};
+
+// Reads Linux perf_event_open hardware counters for the calling thread
+// around the engine hot paths. Totals are inclusive (evaluate contains the
+// legalMoves calls it makes) with the cost of the reads themselves taken
+// out. When counters cannot be opened only wall time is reported.
+class Profiler {
+public:
+  static bool open();
+
+  static void close();
+
+  static bool available(int counter);
+
+  static void sample(ProfileSample *sample);
+
+  static void add(int point, const ProfileSample &start);
+
+  static void reset();
+
+  static void report(long nodes);
+
+  static bool writeJson(const char *path, long nodes);
+
+  static int bench(const Options &options, int searches);
+
+  static const char *pointNames[ProfilePoints];
+
+  static const char *counterNames[Counters];
+};
+
+class ProfileGuard {
+public:
+  explicit ProfileGuard(int point) : point(point) { Profiler::sample(&start); }
+
+  ~ProfileGuard() { Profiler::add(point, start); }
+
+private:
+  int point;
+  ProfileSample start;
+};
+
+#ifdef PROFILE
+#define PROFILE_SCOPE(point) ProfileGuard profileGuard(point)
+#else
+#define PROFILE_SCOPE(point)
+#endif
+
+#endif
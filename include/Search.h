@@ -0,0 +1,154 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "Board.h"
+#include "Book.h"
+#include "Endgame.h"
+#include "EvalCache.h"
+#include "Move.h"
+#include "Options.h"
+#include "SolvedCache.h"
+#include "Task.h"
+#include "TranspositionTable.h"
+
+#define TIME_CHECK 1024
+#define TASK_SOLVE_EMPTIES 6
+
+// One ranked root move: its exact score from the point of view of the
+// side to move (higher is better) and the line the table predicts.
+struct PVLine {
+  Move move;
+  int score;
+  std::vector<Move> pv;
+};
+
+typedef std::function<void(int depth, const std::vector<PVLine> &lines)> AnalysisCallback;
+
+template<int N>
+class BasicSearch {
+public:
+  typedef BasicBoard<N> Board;
+  typedef BasicPosition<N> Position;
+  typedef typename Position::Mask Mask;
+
+  BasicSearch(TranspositionTable *table, Book *book, const Options &options, SolvedCache *cache = nullptr);
+
+  Move bestMove(Board *board, int color);
+
+  int minimax(Board *board, int depth, int alpha, int beta, bool maximizingPlayer);
+
+  // The search itself runs on the bitboard position: move generation,
+  // move making and evaluation never touch a Board.
+  int minimax(const Position &position, int depth, int alpha, int beta, bool maximizingPlayer);
+
+  // Ranks the best `lines` root moves at each depth. Once `lines` moves
+  // have exact scores, the remaining roots are searched with the worst of
+  // them as a bound and only enter the ranking if they beat it. callback,
+  // if set, gets the ranking every time it changes.
+  std::vector<PVLine> analyze(Board *board, int color, int lines, const AnalysisCallback &callback = nullptr);
+
+  // Coroutine variants of bestMove and minimax for SearchScheduler. When
+  // yieldNodes is set they suspend every yieldNodes nodes, leaving the
+  // innermost frame in suspended for the scheduler to resume. The time
+  // limit counts from construction rather than from the first resume.
+  Task<Move> bestMoveTask(Board board, int color);
+
+  Task<int> minimaxTask(Position position, int depth, int alpha, int beta, bool maximizingPlayer);
+
+  // Exact solve for minimaxTask in disc units, like BasicEndgame::solve,
+  // and through the same cutoffs and cache steps. It suspends and checks
+  // the clock before every move it tries above TASK_SOLVE_EMPTIES, so one
+  // endgame never holds the scheduler for more than a small solve. Only
+  // the outermost call is given the cache, as with BasicEndgame::solve.
+  Task<int> solveTask(Position position, int color, int alpha, int beta, SolvedCache *cache = nullptr);
+
+  int solveEndgame(const Position &position, int alpha, int beta, bool maximizingPlayer);
+
+  // Scores position for LIGHT. Inside an (alpha, beta) window the cheap
+  // disc and stability terms are tried first: if even the widest mobility
+  // swing cannot bring the score into the window, that bound is returned
+  // without generating moves and *lazy is set.
+  static int evaluate(const Position &position, int color, int alpha = std::numeric_limits<int>::min(),
+                      int beta = std::numeric_limits<int>::max(), bool *lazy = nullptr);
+
+  static int otherColor(int color);
+
+  // Evaluation weights by the number of discs on the board.
+  static int colorScoreWeight(int discs);
+
+  static int stabilityScoreWeight(int discs);
+
+  static int mobilityScoreWeight(int discs);
+
+  static uint32_t evalTag();
+
+  long nodes() const;
+
+  long evalHits() const;
+
+  long lazyEvals() const;
+
+  long fullEvals() const;
+
+  int bestScore = 0;
+  int depthReached = 0;
+  int yieldNodes = 0;
+  std::coroutine_handle<> suspended;
+
+  // Leaf evaluations go through evalCache and lazy evaluation; off, every
+  // leaf gets a full evaluation.
+  bool fastEval = true;
+
+  static EvalCache evalCache;
+
+private:
+  bool prepareRoots(Board *board, int color, std::vector<Move> &roots, Move *move);
+
+  void pickBest(int color, int depth, std::vector<Move> &roots, const std::vector<int> &scores, Move *move);
+
+  void searchRoots(Board *board, int color, int depth, const std::vector<Move> &roots, std::vector<int> &scores);
+
+  std::vector<Move> principalVariation(Position position, int color, int length);
+
+  bool probe(uint64_t key, int symmetry, int depth, int &alpha, int &beta, int *ttMove, int *value);
+
+  void store(uint64_t key, int symmetry, int depth, int alphaOrig, int betaOrig, int best, int bestSquare);
+
+  bool timeUp(bool force = false);
+
+  static void discWindow(int color, int alpha, int beta, int *lo, int *hi);
+
+  // Exact score for LIGHT of a finished game, in search units.
+  static int finalValue(const Position &position);
+
+  int evaluateLeaf(const Position &position, int color, int alpha, int beta);
+
+  TranspositionTable *table;
+  Book *book;
+  SolvedCache *cache;
+  uint32_t cacheTag = 0;
+  Options options;
+  std::chrono::steady_clock::time_point started;
+  std::chrono::steady_clock::time_point deadline;
+  std::atomic<bool> stopped{false};
+  std::atomic<long> nodeCount{0};
+  std::atomic<long> hitCount{0};
+  std::atomic<long> lazyCount{0};
+  std::atomic<long> fullCount{0};
+  int sinceYield = 0;
+};
+
+extern template class BasicSearch<6>;
+extern template class BasicSearch<8>;
+extern template class BasicSearch<10>;
+
+typedef BasicSearch<SIZE> Search;
+
+#endif
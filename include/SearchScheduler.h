@@ -0,0 +1,60 @@
+#ifndef SEARCH_SCHEDULER_H
+#define SEARCH_SCHEDULER_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Board.h"
+#include "Book.h"
+#include "Move.h"
+#include "Options.h"
+#include "Search.h"
+#include "Task.h"
+#include "TranspositionTable.h"
+
+#define YIELD_NODES 64
+#define SLICE_US 200
+#define BENCH_LOAD 0.7
+
+struct SearchJob {
+  SearchJob(TranspositionTable *table, Book *book, const Options &options);
+
+  Search search;
+  Task<Move> task;
+  std::coroutine_handle<> next;
+  std::function<void(Move, const Search &)> done;
+  int priority;
+  double pass;
+};
+
+// Runs many searches on the calling thread. Each search is a coroutine
+// that yields every YIELD_NODES nodes; the job with the lowest pass runs
+// for up to SLICE_US and then pays for the time it used divided by its
+// priority (stride scheduling), so a priority 2 search gets twice the CPU
+// of a priority 1 search and none of them starve.
+class SearchScheduler {
+public:
+  SearchScheduler(TranspositionTable *table, Book *book, const Options &options);
+
+  void submit(const Board &board, int color, int priority, std::function<void(Move, const Search &)> done);
+
+  bool step();
+
+  void run();
+
+  size_t size() const;
+
+  static int bench(const Options &options, int searches);
+
+private:
+  TranspositionTable *table;
+  Book *book;
+  Options options;
+  double pass = 0;
+  std::vector<std::unique_ptr<SearchJob>> jobs;
+};
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Board.h"
+#include "Book.h"
+#include "Move.h"
+#include "Options.h"
+#include "Position.h"
+#include "Search.h"
+#include "SolvedCache.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+
+#define SERVER_BACKLOG 128
+#define SERVER_READ 4096
+#define SERVER_LINE 65536
+#define SERVER_OUTPUT (1 << 20)
+#define SERVER_LATENCIES 4096
+#define BENCH_CONNECTIONS 8
+
+// Line protocol, one command per line:
+//   new                      -> <id> ok
+//   <id> move <square>       -> <id> ok | <id> error illegal
+//   <id> go [ms]             -> <id> bestmove <square>
+//   <id> analyze <k> [ms]    -> <id> pv <depth> <rank> <score> <square>...
+//                               for each ranking update, then
+//                               <id> analysis done <depth>
+//   <id> board               -> <id> board <64 chars of x, o, .> <x|o>
+//   <id> close               -> <id> ok
+//   setoption <name> <value> -> ok | error option | error busy
+//                               (hash only while no search is running;
+//                               threads, cache and weights are fixed)
+//   stats                    -> stats <count> <p50 us> <p99 us>
+//                               (percentiles of the last SERVER_LATENCIES moves)
+// Squares are written as in the GUI: column letter, row number ("d3").
+// A side with no legal move passes automatically; when neither side can
+// move the reply to the last move is followed by "<id> gameover <dark> <light>".
+
+// A go or analyze request waiting for a worker. budget counts from arrival.
+struct Job {
+  uint32_t session;
+  int budget;
+  int lines;
+  std::chrono::steady_clock::time_point arrival;
+};
+
+// Client sockets are non-blocking: replies queue in output and go out as
+// the socket drains, and a client is not read from while its output is
+// over SERVER_OUTPUT, so one slow reader never stalls the others.
+// Searches wait in jobs until the connection's turn comes round.
+struct Client {
+  std::string input;
+  std::string output;
+  std::deque<Job> jobs;
+};
+
+struct Session {
+  Position position;
+  int32_t client;
+  int8_t turn;
+  uint8_t active;
+  uint8_t busy;
+};
+
+enum CompletionKinds {
+  CompletionMove, CompletionInfo, CompletionAnalysis
+};
+
+struct Completion {
+  int client;
+  uint32_t session;
+  int kind;
+  Move move;
+  int64_t latency;
+  std::string text;
+};
+
+class Server {
+public:
+  Server(const Options &options, Book *book);
+
+  ~Server();
+
+  bool listen(const std::string &address);
+
+  void run();
+
+  void stop();
+
+  std::string stats();
+
+  static std::string squareName(int col, int row);
+
+  static bool parseSquare(const std::string &name, int *col, int *row);
+
+  static int bench(const Options &options, int sessions);
+
+private:
+  void acceptClient();
+
+  bool readClient(int fd);
+
+  bool writeClient(int fd);
+
+  void closeClient(int fd);
+
+  void handleLine(int fd, const std::string &line);
+
+  void schedule(int fd, uint32_t id, int budget, int lines);
+
+  void dispatch();
+
+  void start(int fd, const Job &job);
+
+  void post(const Completion &completion);
+
+  void finishCompletions();
+
+  bool play(Session &session, int col, int row);
+
+  void reply(int fd, const std::string &line);
+
+  Options options;
+  TranspositionTable table;
+  std::unique_ptr<SolvedCache> cache;
+  Book *book;
+
+  std::vector<Session> sessions;
+  std::vector<uint32_t> freeSessions;
+  std::unordered_map<int, Client> clients;
+
+  // Connections with queued jobs, served round-robin one job at a time,
+  // so a client with many sessions cannot crowd out the others. At most
+  // one job per worker is handed to the pool.
+  std::deque<int> ready;
+  int searching = 0;
+
+  int listenFd = -1;
+  int wakeFds[2] = {-1, -1};
+  std::string socketPath;
+  std::atomic<bool> running{false};
+
+  std::mutex completionMutex;
+  std::vector<Completion> completions;
+
+  // Ring of the most recent move latencies; latencyCount counts them all.
+  std::mutex statsMutex;
+  std::vector<int64_t> latencies;
+  uint64_t latencyCount = 0;
+
+  // Shut down first thing in ~Server, before the pipe and clients close.
+  ThreadPool pool;
+};
+
+#endif
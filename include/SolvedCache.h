@@ -0,0 +1,100 @@
+#ifndef SOLVED_CACHE_H
+#define SOLVED_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TranspositionTable.h"
+
+// On-disk layout (little-endian): CacheHeader, then CacheRecords appended
+// back to back. Readers stop at the first record whose check fails.
+// Writers append whole batches under flock(), first cutting the file
+// back to its last good record, and fdatasync() each batch. A batch goes
+// out once it holds CACHE_BATCH records or its oldest record is
+// CACHE_FLUSH_MS old; callers flush() after each search as well.
+
+#define CACHE_FILE "reversi.cache"
+#define CACHE_MAGIC 0x43535652
+#define CACHE_VERSION 1
+#define CACHE_BATCH 64
+#define CACHE_FLUSH_MS 1000
+#define CACHE_REFRESH_MS 1000
+#define CACHE_READ 4096
+#define CACHE_MIN_DEPTH 5
+#define CACHE_MIN_EMPTIES 8
+#define CACHE_SOLVED 100
+
+struct CacheHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t recordSize;
+  uint64_t reserved;
+};
+
+struct CacheRecord {
+  uint64_t key;
+  uint64_t data;
+  uint32_t tag;
+  uint32_t check;
+};
+
+static_assert(sizeof(CacheHeader) == 16, "CacheHeader must stay 16 bytes");
+static_assert(sizeof(CacheRecord) == 24, "CacheRecord must stay 24 bytes");
+
+// Entries are keyed by canonical position key plus a tag: the board size
+// for exact endgame results (stored at depth CACHE_SOLVED), or a hash of
+// the evaluation weights for search results, so a weights change never
+// serves stale heuristic scores.
+class SolvedCache {
+public:
+  explicit SolvedCache(const std::string &path = CACHE_FILE);
+
+  ~SolvedCache();
+
+  SolvedCache(const SolvedCache &) = delete;
+
+  SolvedCache &operator=(const SolvedCache &) = delete;
+
+  bool probe(uint64_t key, uint32_t tag, TTEntry *entry);
+
+  void store(uint64_t key, uint32_t tag, int value, int depth, int flag, int move);
+
+  void flush();
+
+  size_t size();
+
+  const std::string &path() const;
+
+private:
+  bool open();
+
+  void refresh();
+
+  bool scan();
+
+  bool insert(const CacheRecord &record);
+
+  std::string filePath;
+  int fd = -1;
+  std::once_flag opened;
+
+  std::shared_mutex indexMutex;
+  std::unordered_map<uint64_t, uint64_t> index;
+
+  std::mutex refreshMutex;
+  size_t scanned = 0;
+  bool foreign = false;
+  std::atomic<int64_t> nextRefresh{0};
+
+  std::mutex writeMutex;
+  std::vector<CacheRecord> pending;
+  int64_t pendingSince = 0;
+};
+
+#endif
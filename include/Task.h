@@ -0,0 +1,91 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+// Lazily started coroutine returning a T. Awaiting a Task starts it and
+// resumes the awaiter when it finishes, using symmetric transfer so deep
+// recursion does not grow the native stack.
+template<typename T>
+class Task {
+public:
+  struct promise_type {
+    std::optional<T> value;
+    std::coroutine_handle<> continuation;
+
+    struct FinalAwaiter {
+      bool await_ready() noexcept { return false; }
+
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+        auto continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+      }
+
+      void await_resume() noexcept {}
+    };
+
+    Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void return_value(T result) { value.emplace(std::move(result)); }
+
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  Task() = default;
+
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+  Task(Task &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+
+  Task &operator=(Task &&other) noexcept {
+    if (this != &other) {
+      if (handle) { handle.destroy(); }
+      handle = std::exchange(other.handle, {});
+    }
+    return *this;
+  }
+
+  Task(const Task &) = delete;
+
+  Task &operator=(const Task &) = delete;
+
+  ~Task() {
+    if (handle) { handle.destroy(); }
+  }
+
+  bool await_ready() const noexcept { return false; }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+    handle.promise().continuation = awaiting;
+    return handle;
+  }
+
+  T await_resume() { return std::move(*handle.promise().value); }
+
+  bool done() const { return !handle || handle.done(); }
+
+  T result() { return std::move(*handle.promise().value); }
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+// Suspends the innermost coroutine and records where to resume it, so
+// control returns to whoever resumed the outermost Task.
+struct Yield {
+  std::coroutine_handle<> *resumeAt;
+
+  bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> handle) noexcept { *resumeAt = handle; }
+
+  void await_resume() const noexcept {}
+};
+
+#endif
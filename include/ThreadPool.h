@@ -0,0 +1,49 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Each worker owns a queue and takes its oldest task first. An idle
+// worker steals the oldest task from the other queues, so requests are
+// served roughly in arrival order no matter which queue they landed in.
+class ThreadPool {
+public:
+  explicit ThreadPool(int threads);
+
+  ~ThreadPool();
+
+  // Runs the tasks already queued, then joins the workers. Safe to call
+  // more than once; the destructor calls it too.
+  void shutdown();
+
+  void submit(std::function<void()> task);
+
+  int size() const;
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void run(int index);
+
+  bool take(int index, std::function<void()> &task);
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+  std::mutex sleepMutex;
+  std::condition_variable wake;
+  std::atomic<int> pending{0};
+  std::atomic<unsigned> next{0};
+  std::atomic<bool> stopping{false};
+};
+
+#endif
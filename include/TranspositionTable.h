@@ -0,0 +1,57 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#define HASH_MB 16
+
+#define TT_EXACT 0
+#define TT_LOWER 1
+#define TT_UPPER 2
+
+#define NO_SQUARE 0xff
+
+struct TTEntry {
+  int32_t value;
+  int8_t depth;
+  uint8_t flag;
+  uint8_t move;
+};
+
+// Each slot stores key ^ data beside data, so a slot torn by concurrent
+// writers fails the key check instead of returning a mixed entry.
+struct TTSlot {
+  std::atomic<uint64_t> check{0};
+  std::atomic<uint64_t> data{0};
+};
+
+class TranspositionTable {
+public:
+  explicit TranspositionTable(size_t megabytes = HASH_MB);
+
+  void resize(size_t megabytes);
+
+  size_t megabytes() const;
+
+  void clear();
+
+  bool probe(uint64_t key, TTEntry *entry) const;
+
+  void store(uint64_t key, int value, int depth, int flag, int move);
+
+  static uint64_t pack(int value, int depth, int flag, int move);
+
+  static TTEntry unpack(uint64_t data);
+
+private:
+  std::unique_ptr<TTSlot[]> slots;
+  size_t count{};
+  uint64_t mask{};
+  size_t size{};
+};
+
+#endif
@@ -0,0 +1,22 @@
+#include "Assets.h"
+
+#include <cstring>
+
+#include <zlib.h>
+
+const Asset *Assets::find(const char *name) {
+  for (int i = 0; i < count; i++)
+    if (strcmp(table[i].name, name) == 0)
+      return &table[i];
+
+  return nullptr;
+}
+
+bool Assets::inflate(const Asset *asset, std::vector<uint8_t> &out) {
+  if (!asset) { return false; }
+
+  out.resize(asset->size);
+  uLongf size = (uLongf) asset->size;
+
+  return uncompress(out.data(), &size, asset->data, (uLong) asset->packedSize) == Z_OK && size == asset->size;
+}
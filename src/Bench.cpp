@@ -0,0 +1,124 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
+#include "Board.h"
+#include "Search.h"
+#include "TranspositionTable.h"
+
+#define EVAL_TIMING 200000
+
+std::vector<BenchPosition> Bench::positions(int count) {
+  std::vector<BenchPosition> result;
+
+  for (unsigned seed = 1; (int) result.size() < count; seed++) {
+    int color;
+    Position position = Position::random(seed, 10 + (int) (seed % 30), &color);
+
+    if (position.legalMoves(color))
+      result.push_back(BenchPosition{position, color});
+  }
+
+  return result;
+}
+
+Options Bench::searchOptions(const Options &options) {
+  Options result = options;
+  result.threads = 1;
+  result.useBook = false;
+  result.cachePath = "";
+  return result;
+}
+
+int64_t Bench::microsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Bench::percentiles(std::vector<int64_t> v, int64_t *p50, int64_t *p99) {
+  if (v.empty()) {
+    *p50 = *p99 = 0;
+    return;
+  }
+
+  std::sort(v.begin(), v.end());
+  *p50 = v[v.size() / 2];
+  *p99 = v[std::min(v.size() - 1, v.size() * 99 / 100)];
+}
+
+static double millisSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int Bench::evaluation(const Options &options, int searches) {
+  Options searchOptions = Bench::searchOptions(options);
+  TranspositionTable table(options.hashSize);
+
+  std::vector<BenchPosition> benches = positions(searches);
+
+  // Cost of one full evaluation and of one settled by the lazy bound, to
+  // price what each run spent on its leaves.
+  auto timeEvaluations = [&](int alpha) {
+    auto start = std::chrono::steady_clock::now();
+    long sum = 0;
+    bool lazy;
+    for (int i = 0; i < EVAL_TIMING; i++)
+      sum += Search::evaluate(benches[(size_t) i % benches.size()].position, i & 1 ? LIGHT : DARK, alpha,
+                              std::numeric_limits<int>::max(), &lazy);
+    volatile long sink = sum;
+    (void) sink;
+    return millisSince(start) * 1e6 / EVAL_TIMING;
+  };
+
+  double fullNs = timeEvaluations(std::numeric_limits<int>::min());
+  double lazyNs = timeEvaluations(std::numeric_limits<int>::max());
+
+  printf("%d searches, depth %d, full evaluation %.1f ns, lazy bound %.1f ns\n", searches, options.depth, fullNs, lazyNs);
+  printf("%-8s %9s %12s %12s %8s %8s %9s\n", "mode", "wall ms", "nodes", "leaves", "hits", "lazy", "full");
+
+  double wall[2];
+  double evalMs[2];
+  std::vector<Move> moves;
+  int same = 0;
+
+  for (int fast = 0; fast < 2; fast++) {
+    table.clear();
+    Search::evalCache.clear();
+
+    long nodes = 0, hits = 0, lazy = 0, full = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < benches.size(); i++) {
+      Board board(benches[i].position);
+      Search search(&table, nullptr, searchOptions);
+      search.fastEval = fast;
+      Move move = search.bestMove(&board, benches[i].color);
+
+      if (!fast) {
+        moves.push_back(move);
+      } else if (move.col == moves[i].col && move.row == moves[i].row) {
+        same++;
+      }
+
+      nodes += search.nodes();
+      hits += search.evalHits();
+      lazy += search.lazyEvals();
+      full += search.fullEvals();
+    }
+
+    wall[fast] = millisSince(start);
+    evalMs[fast] = ((double) full * fullNs + (double) lazy * lazyNs) / 1e6;
+    long leaves = hits + lazy + full;
+
+    printf("%-8s %9.1f %12ld %12ld %7.1f%% %7.1f%% %8.1f%%\n", fast ? "cached" : "full", wall[fast], nodes, leaves,
+           100.0 * (double) hits / (double) std::max(1L, leaves), 100.0 * (double) lazy / (double) std::max(1L, leaves),
+           100.0 * (double) full / (double) std::max(1L, leaves));
+  }
+
+  printf("same best move in %d of %d searches\n", same, searches);
+  printf("estimated evaluation time %.1f -> %.1f ms, search time saved %.1f ms (%.1f%%)\n",
+         evalMs[0], evalMs[1], wall[0] - wall[1], 100.0 * (wall[0] - wall[1]) / wall[0]);
+
+  return EXIT_SUCCESS;
+}
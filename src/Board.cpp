@@ -1,68 +1,152 @@
 #include "Board.h"
-
-const int Board::earlyVals[SIZE][SIZE] = {{2, 0, 1, 1, 1, 1, 0, 2},
-                                          {0, 0, 5, 5, 5, 5, 0, 0},
-                                          {1, 5, 5, 5, 5, 5, 5, 1},
-                                          {1, 5, 5, 5, 5, 5, 5, 1},
-                                          {1, 5, 5, 5, 5, 5, 5, 1},
-                                          {1, 5, 5, 5, 5, 5, 5, 1},
-                                          {0, 0, 5, 5, 5, 5, 0, 0},
-                                          {2, 0, 1, 1, 1, 1, 0, 2}};
-
-const int Board::middleVals[SIZE][SIZE] = {{10, 0, 2, 2, 2, 2, 0, 10},
-                                           { 0, 0, 5, 5, 5, 5, 0,  0},
-                                           { 2, 5, 5, 5, 5, 5, 5,  2},
-                                           { 2, 5, 5, 5, 5, 5, 5,  2},
-                                           { 2, 5, 5, 5, 5, 5, 5,  2},
-                                           { 2, 5, 5, 5, 5, 5, 5,  2},
-                                           { 0, 0, 5, 5, 5, 5, 0,  0},
-                                           {10, 0, 2, 2, 2, 2, 0, 10}};
-
-const int Board::lateVals[SIZE][SIZE] = {{100, 5, 8, 8, 8, 8, 5, 100},
-                                         {  5, 0, 9, 9, 9, 9, 0,   5},
-                                         {  8, 9, 9, 9, 9, 9, 9,   8},
-                                         {  8, 9, 9, 9, 9, 9, 9,   8},
-                                         {  8, 9, 9, 9, 9, 9, 9,   8},
-                                         {  8, 9, 9, 9, 9, 9, 9,   8},
-                                         {  5, 0, 9, 9, 9, 9, 0,   5},
-                                         {100, 5, 8, 8, 8, 8, 5, 100}};
-
-const short Board::neighbors[8][2] = {{-1, -1},
-                                      {-1, 0},
-                                      {-1, 1},
-                                      {0,  1},
-                                      {1,  1},
-                                      {1,  0},
-                                      {1,  -1},
-                                      {0,  -1}};
-
-Board::~Board() {
+#include "Profiler.h"
+
+template<>
+int BasicBoard<6>::earlyVals[6][6] = {{2, 0, 1, 1, 0, 2},
+                                      {0, 0, 5, 5, 0, 0},
+                                      {1, 5, 5, 5, 5, 1},
+                                      {1, 5, 5, 5, 5, 1},
+                                      {0, 0, 5, 5, 0, 0},
+                                      {2, 0, 1, 1, 0, 2}};
+
+template<>
+int BasicBoard<6>::middleVals[6][6] = {{10, 0, 2, 2, 0, 10},
+                                       { 0, 0, 5, 5, 0,  0},
+                                       { 2, 5, 5, 5, 5,  2},
+                                       { 2, 5, 5, 5, 5,  2},
+                                       { 0, 0, 5, 5, 0,  0},
+                                       {10, 0, 2, 2, 0, 10}};
+
+template<>
+int BasicBoard<6>::lateVals[6][6] = {{100, 5, 8, 8, 5, 100},
+                                     {  5, 0, 9, 9, 0,   5},
+                                     {  8, 9, 9, 9, 9,   8},
+                                     {  8, 9, 9, 9, 9,   8},
+                                     {  5, 0, 9, 9, 0,   5},
+                                     {100, 5, 8, 8, 5, 100}};
+
+template<>
+int BasicBoard<8>::earlyVals[8][8] = {{2, 0, 1, 1, 1, 1, 0, 2},
+                                      {0, 0, 5, 5, 5, 5, 0, 0},
+                                      {1, 5, 5, 5, 5, 5, 5, 1},
+                                      {1, 5, 5, 5, 5, 5, 5, 1},
+                                      {1, 5, 5, 5, 5, 5, 5, 1},
+                                      {1, 5, 5, 5, 5, 5, 5, 1},
+                                      {0, 0, 5, 5, 5, 5, 0, 0},
+                                      {2, 0, 1, 1, 1, 1, 0, 2}};
+
+template<>
+int BasicBoard<8>::middleVals[8][8] = {{10, 0, 2, 2, 2, 2, 0, 10},
+                                       { 0, 0, 5, 5, 5, 5, 0,  0},
+                                       { 2, 5, 5, 5, 5, 5, 5,  2},
+                                       { 2, 5, 5, 5, 5, 5, 5,  2},
+                                       { 2, 5, 5, 5, 5, 5, 5,  2},
+                                       { 2, 5, 5, 5, 5, 5, 5,  2},
+                                       { 0, 0, 5, 5, 5, 5, 0,  0},
+                                       {10, 0, 2, 2, 2, 2, 0, 10}};
+
+template<>
+int BasicBoard<8>::lateVals[8][8] = {{100, 5, 8, 8, 8, 8, 5, 100},
+                                     {  5, 0, 9, 9, 9, 9, 0,   5},
+                                     {  8, 9, 9, 9, 9, 9, 9,   8},
+                                     {  8, 9, 9, 9, 9, 9, 9,   8},
+                                     {  8, 9, 9, 9, 9, 9, 9,   8},
+                                     {  8, 9, 9, 9, 9, 9, 9,   8},
+                                     {  5, 0, 9, 9, 9, 9, 0,   5},
+                                     {100, 5, 8, 8, 8, 8, 5, 100}};
+
+template<>
+int BasicBoard<10>::earlyVals[10][10] = {{2, 0, 1, 1, 1, 1, 1, 1, 0, 2},
+                                         {0, 0, 5, 5, 5, 5, 5, 5, 0, 0},
+                                         {1, 5, 5, 5, 5, 5, 5, 5, 5, 1},
+                                         {1, 5, 5, 5, 5, 5, 5, 5, 5, 1},
+                                         {1, 5, 5, 5, 5, 5, 5, 5, 5, 1},
+                                         {1, 5, 5, 5, 5, 5, 5, 5, 5, 1},
+                                         {1, 5, 5, 5, 5, 5, 5, 5, 5, 1},
+                                         {1, 5, 5, 5, 5, 5, 5, 5, 5, 1},
+                                         {0, 0, 5, 5, 5, 5, 5, 5, 0, 0},
+                                         {2, 0, 1, 1, 1, 1, 1, 1, 0, 2}};
+
+template<>
+int BasicBoard<10>::middleVals[10][10] = {{10, 0, 2, 2, 2, 2, 2, 2, 0, 10},
+                                          { 0, 0, 5, 5, 5, 5, 5, 5, 0,  0},
+                                          { 2, 5, 5, 5, 5, 5, 5, 5, 5,  2},
+                                          { 2, 5, 5, 5, 5, 5, 5, 5, 5,  2},
+                                          { 2, 5, 5, 5, 5, 5, 5, 5, 5,  2},
+                                          { 2, 5, 5, 5, 5, 5, 5, 5, 5,  2},
+                                          { 2, 5, 5, 5, 5, 5, 5, 5, 5,  2},
+                                          { 2, 5, 5, 5, 5, 5, 5, 5, 5,  2},
+                                          { 0, 0, 5, 5, 5, 5, 5, 5, 0,  0},
+                                          {10, 0, 2, 2, 2, 2, 2, 2, 0, 10}};
+
+template<>
+int BasicBoard<10>::lateVals[10][10] = {{100, 5, 8, 8, 8, 8, 8, 8, 5, 100},
+                                        {  5, 0, 9, 9, 9, 9, 9, 9, 0,   5},
+                                        {  8, 9, 9, 9, 9, 9, 9, 9, 9,   8},
+                                        {  8, 9, 9, 9, 9, 9, 9, 9, 9,   8},
+                                        {  8, 9, 9, 9, 9, 9, 9, 9, 9,   8},
+                                        {  8, 9, 9, 9, 9, 9, 9, 9, 9,   8},
+                                        {  8, 9, 9, 9, 9, 9, 9, 9, 9,   8},
+                                        {  8, 9, 9, 9, 9, 9, 9, 9, 9,   8},
+                                        {  5, 0, 9, 9, 9, 9, 9, 9, 0,   5},
+                                        {100, 5, 8, 8, 8, 8, 8, 8, 5, 100}};
+
+template<int N>
+int BasicBoard<N>::earlyStage = N * N * 5 / 16;
+
+template<int N>
+int BasicBoard<N>::middleStage = N * N * 5 / 8;
+
+template<int N>
+const short BasicBoard<N>::neighbors[8][2] = {{-1, -1},
+                                              {-1, 0},
+                                              {-1, 1},
+                                              {0,  1},
+                                              {1,  1},
+                                              {1,  0},
+                                              {1,  -1},
+                                              {0,  -1}};
+
+template<int N>
+BasicBoard<N>::~BasicBoard() {
   delete lastMove;
 }
 
-Board::Board() {
-  for (int row = 0; row < SIZE; row++)
-    for (int col = 0; col < SIZE; col++)
+template<int N>
+BasicBoard<N>::BasicBoard() {
+  for (int row = 0; row < N; row++)
+    for (int col = 0; col < N; col++)
       moves[row][col] = EMPTY;
   totalMoves = 0;
   lastMove = new Move(-1, -1);
 
-  int m = SIZE / 2;
+  int m = N / 2;
   addMove(Move(m - 1, m - 1), LIGHT);
   addMove(Move(m - 1, m), DARK);
   addMove(Move(m, m), LIGHT);
   addMove(Move(m, m - 1), DARK);
 }
 
-Board::Board(Board const &board) {
-  for (int row = 0; row < SIZE; row++)
-    for (int col = 0; col < SIZE; col++)
+template<int N>
+BasicBoard<N>::BasicBoard(BasicBoard const &board) {
+  for (int row = 0; row < N; row++)
+    for (int col = 0; col < N; col++)
       moves[row][col] = board.moves[row][col];
   totalMoves = board.totalMoves;
   lastMove = new Move(board.lastMove);
 }
 
-void Board::flipMove(const Move &move, int color) {
+template<int N>
+BasicBoard<N>::BasicBoard(const BasicPosition<N> &position) {
+  for (int row = 0; row < N; row++)
+    for (int col = 0; col < N; col++)
+      moves[row][col] = position.getColor(col, row);
+  totalMoves = N * N - position.empties();
+  lastMove = new Move(-1, -1);
+}
+
+template<int N>
+void BasicBoard<N>::flipMove(const Move &move, int color) {
   if (moves[move.row][move.col] == EMPTY) {
     std::cout << "Cannot flip empty: col: " << move.col << ", row: " << move.row << std::endl;
     throw;
@@ -71,7 +155,8 @@ void Board::flipMove(const Move &move, int color) {
   moves[move.row][move.col] = color;
 }
 
-void Board::addMove(const Move &move, int color) {
+template<int N>
+void BasicBoard<N>::addMove(const Move &move, int color) {
   if (moves[move.row][move.col] != EMPTY) {
     std::cout << "Cannot add move to occupied: col: " << move.col << ", row: " << move.row << std::endl;
     throw;
@@ -83,7 +168,9 @@ void Board::addMove(const Move &move, int color) {
   lastMove->row = move.row;
 }
 
-void Board::flipPieces(int col, int row, int color) {
+template<int N>
+void BasicBoard<N>::flipPieces(int col, int row, int color) {
+  PROFILE_SCOPE(ProfileFlipPieces);
   int x, y, fx, fy;
   int op = color == DARK ? LIGHT : DARK;
 
@@ -93,14 +180,14 @@ void Board::flipPieces(int col, int row, int color) {
     y = row + neighbors[n][0];
     x = col + neighbors[n][1];
 
-    if (y < 0 || x < 0 || y >= SIZE || x >= SIZE)
+    if (y < 0 || x < 0 || y >= N || x >= N)
       continue;
 
     if (getColor(x, y) == op) {
       y += neighbors[n][0];
       x += neighbors[n][1];
 
-      while (y >= 0 && x >= 0 && y < SIZE && x < SIZE) {
+      while (y >= 0 && x >= 0 && y < N && x < N) {
         if (moves[y][x] == EMPTY) {
           break;
         }
@@ -128,11 +215,12 @@ void Board::flipPieces(int col, int row, int color) {
   }
 }
 
-int Board::getMovesScore(int color) {
+template<int N>
+int BasicBoard<N>::getMovesScore(int color) {
   int total = 0;
 
-  for (int row = 0; row < SIZE; row++)
-    for (int col = 0; col < SIZE; col++)
+  for (int row = 0; row < N; row++)
+    for (int col = 0; col < N; col++)
       if (moves[row][col] == color) {
         switch(stage()) {
           case EARLY:
@@ -150,7 +238,22 @@ int Board::getMovesScore(int color) {
   return total;
 }
 
-bool Board::legalMove(int col, int row, int color) {
+template<int N>
+int BasicBoard<N>::getMovesScore(const BasicPosition<N> &position, int color) {
+  int discs = N * N - position.empties();
+  int (*vals)[N] = discs <= earlyStage ? earlyVals : discs <= middleStage ? middleVals : lateVals;
+  int total = 0;
+
+  for (auto mask = position.discs(color); mask; mask &= mask - 1) {
+    int square = position.firstSquare(mask);
+    total += vals[square / N][square % N];
+  }
+
+  return total;
+}
+
+template<int N>
+bool BasicBoard<N>::legalMove(int col, int row, int color) {
   int x, y;
   int op = color == DARK ? LIGHT : DARK;
 
@@ -161,14 +264,14 @@ bool Board::legalMove(int col, int row, int color) {
     y = row + neighbors[n][0];
     x = col + neighbors[n][1];
 
-    if (y < 0 || x < 0 || y >= SIZE || x >= SIZE)
+    if (y < 0 || x < 0 || y >= N || x >= N)
       continue;
 
     if (moves[y][x] == op) {
       y += neighbors[n][0];
       x += neighbors[n][1];
 
-      while (y >= 0 && x >= 0 && y < SIZE && x < SIZE) {
+      while (y >= 0 && x >= 0 && y < N && x < N) {
         if (moves[y][x] == EMPTY) {
           break;
         }
@@ -186,23 +289,122 @@ bool Board::legalMove(int col, int row, int color) {
   return false;
 }
 
-std::vector<Move> Board::legalMoves(int color) {
+template<int N>
+std::vector<Move> BasicBoard<N>::legalMoves(int color) {
+  PROFILE_SCOPE(ProfileLegalMoves);
   std::vector<Move> v;
 
-  for (int r = 0; r < SIZE; r++)
-    for (int c = 0; c < SIZE; c++)
+  for (int r = 0; r < N; r++)
+    for (int c = 0; c < N; c++)
       if (legalMove(c, r, color))
         v.emplace_back(c, r);
 
   return v;
 }
 
-int Board::getColor(int col, int row) {
+template<int N>
+int BasicBoard<N>::getColor(int col, int row) {
   return moves[row][col];
 }
 
-int Board::stage() {
-  if (totalMoves <= 20) { return EARLY; }
-  if (totalMoves <= 40) { return MIDDLE; }
+template<int N>
+int BasicBoard<N>::stage() {
+  if (totalMoves <= earlyStage) { return EARLY; }
+  if (totalMoves <= middleStage) { return MIDDLE; }
   return LATE;
 }
+
+template<int N>
+struct BuiltinWeights {
+  int early[N][N], middle[N][N], late[N][N];
+  int stages[2];
+};
+
+template<int N>
+static const BuiltinWeights<N> &builtinWeights() {
+  static const BuiltinWeights<N> builtin = [] {
+    BuiltinWeights<N> w;
+    std::copy(&BasicBoard<N>::earlyVals[0][0], &BasicBoard<N>::earlyVals[0][0] + N * N, &w.early[0][0]);
+    std::copy(&BasicBoard<N>::middleVals[0][0], &BasicBoard<N>::middleVals[0][0] + N * N, &w.middle[0][0]);
+    std::copy(&BasicBoard<N>::lateVals[0][0], &BasicBoard<N>::lateVals[0][0] + N * N, &w.late[0][0]);
+    w.stages[0] = BasicBoard<N>::earlyStage;
+    w.stages[1] = BasicBoard<N>::middleStage;
+    return w;
+  }();
+
+  return builtin;
+}
+
+template<int N>
+bool BasicBoard<N>::loadWeights(const char *path) {
+  builtinWeights<N>();
+
+  std::ifstream in(path);
+  if (!in) { return false; }
+
+  int early[N][N], middle[N][N], late[N][N];
+  int stages[2] = {earlyStage, middleStage};
+  std::copy(&earlyVals[0][0], &earlyVals[0][0] + N * N, &early[0][0]);
+  std::copy(&middleVals[0][0], &middleVals[0][0] + N * N, &middle[0][0]);
+  std::copy(&lateVals[0][0], &lateVals[0][0] + N * N, &late[0][0]);
+  std::string token;
+
+  while (in >> token) {
+    int (*table)[N] = nullptr;
+
+    if (token[0] == '#') {
+      std::getline(in, token);
+      continue;
+    }
+
+    if (token == "early") { table = early; }
+    else if (token == "middle") { table = middle; }
+    else if (token == "late") { table = late; }
+    else if (token == "stages") {
+      if (!(in >> stages[0] >> stages[1])) { return false; }
+      continue;
+    } else {
+      return false;
+    }
+
+    for (int row = 0; row < N; row++)
+      for (int col = 0; col < N; col++)
+        if (!(in >> table[row][col])) { return false; }
+  }
+
+  std::copy(&early[0][0], &early[0][0] + N * N, &earlyVals[0][0]);
+  std::copy(&middle[0][0], &middle[0][0] + N * N, &middleVals[0][0]);
+  std::copy(&late[0][0], &late[0][0] + N * N, &lateVals[0][0]);
+  earlyStage = stages[0];
+  middleStage = stages[1];
+  return true;
+}
+
+template<int N>
+void BasicBoard<N>::resetWeights() {
+  const BuiltinWeights<N> &builtin = builtinWeights<N>();
+
+  std::copy(&builtin.early[0][0], &builtin.early[0][0] + N * N, &earlyVals[0][0]);
+  std::copy(&builtin.middle[0][0], &builtin.middle[0][0] + N * N, &middleVals[0][0]);
+  std::copy(&builtin.late[0][0], &builtin.late[0][0] + N * N, &lateVals[0][0]);
+  earlyStage = builtin.stages[0];
+  middleStage = builtin.stages[1];
+}
+
+template<int N>
+BasicPosition<N> BasicBoard<N>::position() const {
+  BasicPosition<N> position;
+
+  for (int row = 0; row < N; row++)
+    for (int col = 0; col < N; col++) {
+      auto bit = position.bit(position.square(col, row));
+      if (moves[row][col] == DARK) { position.dark |= bit; }
+      if (moves[row][col] == LIGHT) { position.light |= bit; }
+    }
+
+  return position;
+}
+
+template class BasicBoard<6>;
+template class BasicBoard<8>;
+template class BasicBoard<10>;
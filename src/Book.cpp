@@ -0,0 +1,78 @@
+#include "Book.h"
+#include "Board.h"
+
+// A move in canonical coordinates, picking the lowest square among the
+// moves a symmetric position cannot tell apart, so that they are
+// counted together.
+static uint8_t canonicalSquare(const Position &position, int square, int symmetry) {
+  Position canonical = position.transformed(symmetry);
+  int mapped = Position::transformSquare(square, symmetry);
+  int best = mapped;
+
+  for (int s = 1; s < SYMMETRIES; s++) {
+    Position p = canonical.transformed(s);
+    if (p.dark == canonical.dark && p.light == canonical.light)
+      best = std::min(best, Position::transformSquare(mapped, s));
+  }
+
+  return (uint8_t) best;
+}
+
+bool Book::load(const char *path) {
+  GameRecordFile file(path);
+  if (!file.isOpen()) { return false; }
+
+  for (auto record : file)
+    add(record);
+
+  return true;
+}
+
+void Book::add(const RecordView &record) {
+  Position position = Position::initial();
+  int turn = DARK;
+  int plies = std::min(record.moveCount(), BOOK_PLIES);
+
+  for (int i = 0; i < plies; i++) {
+    if (!position.legalMoves(turn))
+      turn = turn == DARK ? LIGHT : DARK;
+
+    // A bad or foreign record stops contributing at its first illegal move.
+    if (record.moves[i] >= SIZE * SIZE || !(position.legalMoves(turn) & Position::bit(record.moves[i]))) { return; }
+
+    int symmetry;
+    uint64_t key = position.key(turn, &symmetry);
+    uint8_t square = canonicalSquare(position, record.moves[i], symmetry);
+    int score = turn == DARK ? record.header->result : -record.header->result;
+
+    auto &moves = entries[key];
+    auto it = std::find_if(moves.begin(), moves.end(), [&](const BookMove &m) { return m.square == square; });
+    if (it == moves.end()) {
+      moves.push_back(BookMove{square, 1, score});
+    } else {
+      it->games++;
+      it->score += score;
+    }
+
+    position.play(record.moves[i], turn);
+    turn = turn == DARK ? LIGHT : DARK;
+  }
+}
+
+Move Book::probe(const Position &position, int color) const {
+  int symmetry;
+  auto found = entries.find(position.key(color, &symmetry));
+  if (found == entries.end()) { return Move(-1, -1); }
+
+  const BookMove *best = nullptr;
+  for (auto &m : found->second)
+    if (!best || (int64_t) m.score * best->games > (int64_t) best->score * m.games)
+      best = &m;
+
+  int square = Position::transformSquare(best->square, Position::inverse(symmetry));
+  return Move(square % SIZE, square / SIZE);
+}
+
+size_t Book::size() const {
+  return entries.size();
+}
@@ -0,0 +1,118 @@
+#include "Endgame.h"
+
+#include <algorithm>
+
+#include "SolvedCache.h"
+
+template<int N>
+int BasicEndgame<N>::finalScore(const BasicPosition<N> &position, int color) {
+  int mine = position.count(color);
+  int theirs = position.count(color == DARK ? LIGHT : DARK);
+  int empties = position.empties();
+
+  if (mine > theirs) { return mine - theirs + empties; }
+  if (mine < theirs) { return mine - theirs - empties; }
+  return 0;
+}
+
+template<int N>
+int BasicEndgame<N>::stabilityBound(const BasicPosition<N> &position, int color) {
+  return N * N - 2 * position.bitCount(position.stable(color == DARK ? LIGHT : DARK));
+}
+
+template<int N>
+bool BasicEndgame<N>::cutoff(const BasicPosition<N> &position, int color, typename BasicPosition<N>::Mask moves, int alpha, int beta, int *score) {
+  int other = color == DARK ? LIGHT : DARK;
+
+  if (!moves) {
+    if (position.legalMoves(other)) { return false; }
+    *score = finalScore(position, color);
+    return true;
+  }
+
+  if (position.empties() < STABILITY_EMPTIES) { return false; }
+
+  int upper = stabilityBound(position, color);
+  if (upper <= alpha) {
+    *score = upper;
+    return true;
+  }
+
+  int lower = -stabilityBound(position, other);
+  if (lower >= beta) {
+    *score = lower;
+    return true;
+  }
+
+  return false;
+}
+
+template<int N>
+int BasicEndgame<N>::solve(const BasicPosition<N> &position, int color, int alpha, int beta) {
+  int other = color == DARK ? LIGHT : DARK;
+  auto moves = position.legalMoves(color);
+  int best;
+
+  if (cutoff(position, color, moves, alpha, beta, &best)) { return best; }
+  if (!moves) { return -solve(position, other, -beta, -alpha); }
+
+  best = -N * N;
+
+  while (moves) {
+    int square = position.firstSquare(moves);
+    moves &= moves - 1;
+
+    BasicPosition<N> child = position;
+    child.play(square, color);
+
+    int score = -solve(child, other, -beta, -alpha);
+    if (score > best) {
+      best = score;
+      if (best > alpha) {
+        alpha = best;
+        if (alpha >= beta) { break; }
+      }
+    }
+  }
+
+  return best;
+}
+
+template<int N>
+bool BasicEndgame<N>::probeCache(SolvedCache *cache, const BasicPosition<N> &position, int color, int &alpha, int &beta, int *score) {
+  if (!cache || position.empties() < CACHE_MIN_EMPTIES) { return false; }
+
+  TTEntry entry{};
+  if (!cache->probe(position.key(color), N, &entry) || entry.depth != CACHE_SOLVED) { return false; }
+
+  *score = entry.value;
+  if (entry.flag == TT_EXACT) { return true; }
+  if (entry.flag == TT_LOWER) { alpha = std::max(alpha, (int) entry.value); }
+  if (entry.flag == TT_UPPER) { beta = std::min(beta, (int) entry.value); }
+  return alpha >= beta;
+}
+
+template<int N>
+void BasicEndgame<N>::storeCache(SolvedCache *cache, const BasicPosition<N> &position, int color, int alpha, int beta, int score) {
+  if (!cache || position.empties() < CACHE_MIN_EMPTIES) { return; }
+
+  int flag = TT_EXACT;
+  if (score <= alpha) { flag = TT_UPPER; }
+  else if (score >= beta) { flag = TT_LOWER; }
+
+  cache->store(position.key(color), N, score, CACHE_SOLVED, flag, NO_SQUARE);
+}
+
+template<int N>
+int BasicEndgame<N>::solve(const BasicPosition<N> &position, int color, int alpha, int beta, SolvedCache *cache) {
+  int score;
+  if (probeCache(cache, position, color, alpha, beta, &score)) { return score; }
+
+  score = solve(position, color, alpha, beta);
+  storeCache(cache, position, color, alpha, beta, score);
+  return score;
+}
+
+template class BasicEndgame<6>;
+template class BasicEndgame<8>;
+template class BasicEndgame<10>;
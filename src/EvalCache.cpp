@@ -0,0 +1,31 @@
+#include "EvalCache.h"
+
+#define EVAL_FILLED (1ULL << 32)
+
+EvalCache::EvalCache(size_t count) : slots(new TTSlot[count]), mask(count - 1) {}
+
+bool EvalCache::probe(uint64_t key, int *value) const {
+  const TTSlot &slot = slots[key & mask];
+  uint64_t data = slot.data.load(std::memory_order_relaxed);
+  uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+  if ((check ^ data) != key || !(data & EVAL_FILLED)) { return false; }
+
+  *value = (int32_t) (uint32_t) data;
+  return true;
+}
+
+void EvalCache::store(uint64_t key, int value) {
+  TTSlot &slot = slots[key & mask];
+  uint64_t data = (uint64_t) (uint32_t) value | EVAL_FILLED;
+
+  slot.check.store(key ^ data, std::memory_order_relaxed);
+  slot.data.store(data, std::memory_order_relaxed);
+}
+
+void EvalCache::clear() {
+  for (uint64_t i = 0; i <= mask; i++) {
+    slots[i].check.store(0, std::memory_order_relaxed);
+    slots[i].data.store(0, std::memory_order_relaxed);
+  }
+}
@@ -1,15 +1,16 @@
 
 #include "Game.h"
 
+const char *Game::buttonAssets[BtnCount] = {"btn_options", "btn_quit", "btn_yes", "btn_no"};
+
 Game::~Game() {
   TTF_CloseFont(font15);
   TTF_CloseFont(font21);
   TTF_Quit();
 
-  SDL_DestroyTexture(btnTextures[BtnOptions]);
-  SDL_DestroyTexture(btnTextures[BtnQuit]);
-  SDL_DestroyTexture(btnTextures[BtnYes]);
-  SDL_DestroyTexture(btnTextures[BtnNo]);
+  for (auto texture : btnTextures)
+    if (texture)
+      SDL_DestroyTexture(texture);
 
   SDL_DestroyTexture(bgTexture);
   SDL_DestroyRenderer(renderer);
@@ -17,8 +18,11 @@ Game::~Game() {
   SDL_Quit();
 }
 
-Game::Game(const char *title) {
-  if (SDL_Init(SDL_INIT_EVERYTHING)) {
+Game::Game(const char *title, const Options &options) : options(options), weightsPath(options.evalWeights),
+                                                       table(options.hashSize) {
+  decoded = std::async(std::launch::async, &Game::decodeAssets, this);
+
+  if (SDL_Init(SDL_INIT_VIDEO)) {
     printf("SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
     exit(EXIT_FAILURE);
   }
@@ -40,71 +44,73 @@ Game::Game(const char *title) {
   }
 
   SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+  SDL_RenderClear(renderer);
+  SDL_RenderPresent(renderer);
+  firstFrame = std::chrono::steady_clock::now();
 
-  bgSurface = SDL_LoadBMP("res/img/bg.bmp");
-  if (bgSurface == nullptr) {
-    printf("Unable to load image %s! SDL Error: %s\n", "res/img/bg.bmp", SDL_GetError());
+  if (TTF_Init() == -1) {
+    printf("TTF_Init failed: %s\n", TTF_GetError());
     exit(EXIT_FAILURE);
   }
 
-  bgTexture = SDL_CreateTextureFromSurface(renderer, bgSurface);
-  SDL_FreeSurface(bgSurface);
+  book.load(options.dataPath(BOOK).c_str());
+  applyOptions();
 
-  btnOptionsSurface = SDL_LoadBMP("res/img/btn_options.bmp");
-  btnQuitSurface = SDL_LoadBMP("res/img/btn_quit.bmp");
-  btnYesSurface = SDL_LoadBMP("res/img/btn_yes.bmp");
-  btnNoSurface = SDL_LoadBMP("res/img/btn_no.bmp");
+  newGame();
 
-  if (btnOptionsSurface == nullptr) {
-    printf("Unable to load image %s! SDL Error: %s\n", "res/img/btn_options.bmp", SDL_GetError());
+  if (!decoded.get()) {
+    printf("Unable to decode embedded assets!\n");
     exit(EXIT_FAILURE);
   }
 
-  if (btnQuitSurface == nullptr) {
-    printf("Unable to load image %s! SDL Error: %s\n", "res/img/btn_quit.bmp", SDL_GetError());
-    exit(EXIT_FAILURE);
-  }
+  bgTexture = createTexture(Assets::find(BACKGROUND), bgPixels);
+  font15 = openFont(15);
+  font21 = openFont(21);
 
-  if (btnYesSurface == nullptr) {
-    printf("Unable to load image %s! SDL Error: %s\n", "res/img/btn_yes.bmp", SDL_GetError());
-    exit(EXIT_FAILURE);
-  }
+  running = true;
+}
 
-  if (btnNoSurface == nullptr) {
-    printf("Unable to load image %s! SDL Error: %s\n", "res/img/btn_no.bmp", SDL_GetError());
-    exit(EXIT_FAILURE);
-  }
+bool Game::decodeAssets() {
+  if (!Assets::inflate(Assets::find(BACKGROUND), bgPixels)) { return false; }
+  if (!Assets::inflate(Assets::find(FONT), fontData)) { return false; }
 
-  btnTextures[BtnOptions] = SDL_CreateTextureFromSurface(renderer, btnOptionsSurface);
-  btnTextures[BtnQuit] = SDL_CreateTextureFromSurface(renderer, btnQuitSurface);
-  btnTextures[BtnYes] = SDL_CreateTextureFromSurface(renderer, btnYesSurface);
-  btnTextures[BtnNo] = SDL_CreateTextureFromSurface(renderer, btnNoSurface);
+  for (int i = 0; i < BtnCount; i++)
+    if (!Assets::inflate(Assets::find(buttonAssets[i]), btnPixels[i])) { return false; }
 
-  SDL_FreeSurface(btnOptionsSurface);
-  SDL_FreeSurface(btnQuitSurface);
-  SDL_FreeSurface(btnYesSurface);
-  SDL_FreeSurface(btnNoSurface);
+  return true;
+}
 
-  if (TTF_Init() == -1) {
-    printf("TTF_Init failed: %s\n", TTF_GetError());
+SDL_Texture *Game::createTexture(const Asset *asset, std::vector<uint8_t> &pixels) {
+  SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                           asset->width, asset->height);
+  if (!texture) {
+    printf("Unable to create texture %s! SDL Error: %s\n", asset->name, SDL_GetError());
     exit(EXIT_FAILURE);
   }
 
-  font15 = TTF_OpenFont(FONT, 15);
-  if (font15 == nullptr) {
-    printf("Failed to load font15! Error: %s\n", TTF_GetError());
-    exit(EXIT_FAILURE);
-  }
+  SDL_UpdateTexture(texture, nullptr, pixels.data(), asset->width * 4);
+  if (asset->flags & ASSET_ALPHA)
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
 
-  font21 = TTF_OpenFont(FONT, 21);
-  if (font21 == nullptr) {
-    printf("Failed to load font21! Error: %s\n", TTF_GetError());
+  std::vector<uint8_t>().swap(pixels);
+  return texture;
+}
+
+SDL_Texture *Game::buttonTexture(int button) {
+  if (!btnTextures[button])
+    btnTextures[button] = createTexture(Assets::find(buttonAssets[button]), btnPixels[button]);
+
+  return btnTextures[button];
+}
+
+TTF_Font *Game::openFont(int size) {
+  TTF_Font *font = TTF_OpenFontRW(SDL_RWFromConstMem(fontData.data(), (int) fontData.size()), 1, size);
+  if (font == nullptr) {
+    printf("Failed to load font%d! Error: %s\n", size, TTF_GetError());
     exit(EXIT_FAILURE);
   }
 
-  newGame();
-
-  running = true;
+  return font;
 }
 
 bool Game::isRunning() {
@@ -136,12 +142,14 @@ void Game::clean() {
 
 void Game::render() {
   SDL_RenderClear(renderer);
-  SDL_RenderCopy(renderer, bgTexture, nullptr, nullptr);
+  SDL_Rect boardRect = {.x = 0, .y = 0, .w = SCREEN_W, .h = SCREEN_W};
+  SDL_RenderCopy(renderer, bgTexture, nullptr, &boardRect);
 
   drawGrid();
   drawLastMove();
   drawDiscs();
   drawLegalMoves();
+  drawFooter();
   drawMenu();
 
   SDL_RenderPresent(renderer);
@@ -166,8 +174,151 @@ void Game::drawMenu() {
   }
 }
 
+void Game::drawFooter() {
+  SDL_SetRenderDrawColor(renderer, 0x33, 0x33, 0x33, 0xff);
+  SDL_Rect rect = {.x = 0, .y = SCREEN_W, .w = SCREEN_W, .h = FOOTER};
+  SDL_RenderFillRect(renderer, &rect);
+
+  bool enabled = currentMenu == MenuNone && isPlayerTurn();
+
+  SDL_Rect clip;
+  clip.x = 0;
+  clip.y = enabled ? BtnUp : BtnOff;
+  clip.w = BTN_W;
+  clip.h = BTN_H;
+
+  btnRects[BtnOptions].x = LABEL;
+  btnRects[BtnOptions].y = SCREEN_W + (BTN_SPACE / 2);
+  btnRects[BtnOptions].w = BTN_W;
+  btnRects[BtnOptions].h = BTN_H;
+
+  SDL_RenderCopy(renderer, buttonTexture(BtnOptions), &clip, &btnRects[BtnOptions]);
+  writeText("or right-click the board", LABEL + BTN_W + BTN_SPACE, SCREEN_W + (FOOTER / 2) - 9, font15);
+}
+
 void Game::drawOptionsMenu() {
-  // TODO
+  SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xcc);
+  SDL_Rect rect;
+  rect.x = SCREEN_W / 2 - 160;
+  rect.y = SCREEN_W / 2 - 165;
+  rect.h = 330;
+  rect.w = 320;
+  SDL_RenderFillRect(renderer, &rect);
+
+  SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xff);
+  SDL_RenderDrawRect(renderer, &rect);
+
+  writeText("Options", rect.x + 24, rect.y + 16, font21);
+
+  for (int i = 0; i < OptCount; i++) {
+    optionRects[i].x = rect.x + 24;
+    optionRects[i].y = rect.y + 60 + i * 36;
+    optionRects[i].w = rect.w - 48;
+    optionRects[i].h = 32;
+    writeText(optionLabel(i).c_str(), optionRects[i].x, optionRects[i].y, font21);
+  }
+}
+
+std::string Game::optionLabel(int option) {
+  std::ostringstream label;
+
+  switch (option) {
+    case OptTime:
+      label << "Time per move: ";
+      if (options.timePerMove) { label << options.timePerMove << " ms"; } else { label << "none"; }
+      break;
+    case OptDepth:
+      label << "Depth: " << options.depth;
+      break;
+    case OptThreads:
+      label << "Threads: " << options.threads;
+      break;
+    case OptHash:
+      label << "Hash: " << options.hashSize << " MB";
+      break;
+    case OptBook:
+      label << "Book: " << options.get("book");
+      break;
+    case OptWeights:
+      label << "Weights: " << (options.evalWeights.empty() ? "default" : options.evalWeights);
+      break;
+    case OptDone:
+      label << "Done";
+      break;
+  }
+
+  return label.str();
+}
+
+static int nextValue(const std::vector<int> &values, int current) {
+  for (int v : values)
+    if (v > current) { return v; }
+  return values.front();
+}
+
+void Game::cycleOption(int option) {
+  int cores = std::max(1, (int) std::thread::hardware_concurrency());
+
+  switch (option) {
+    case OptTime:
+      options.timePerMove = nextValue({0, 250, 500, 1000, 2000, 5000, 10000}, options.timePerMove);
+      break;
+    case OptDepth:
+      options.depth = options.depth % 10 + 1;
+      break;
+    case OptThreads:
+      options.threads = options.threads % cores + 1;
+      break;
+    case OptHash:
+      options.hashSize = nextValue({8, 16, 32, 64, 128, 256, 512}, options.hashSize);
+      break;
+    case OptBook:
+      options.useBook = !options.useBook;
+      break;
+    case OptWeights:
+      options.evalWeights = options.evalWeights.empty() ? weightsPath : "";
+      break;
+  }
+
+  applyOptions();
+}
+
+void Game::applyOptions() {
+  if (table.megabytes() != (size_t) options.hashSize)
+    table.resize((size_t) options.hashSize);
+
+  if (options.evalWeights != weightsLoaded) {
+    if (options.evalWeights.empty()) {
+      Board::resetWeights();
+    } else if (!Board::loadWeights(options.evalWeights.c_str())) {
+      printf("Unable to load weights %s\n", options.evalWeights.c_str());
+      Board::resetWeights();
+      options.evalWeights.clear();
+    }
+    weightsLoaded = options.evalWeights;
+    table.clear();
+  }
+
+  if (options.cachePath.empty()) {
+    cache.reset();
+  } else if (!cache || cache->path() != options.cachePath) {
+    cache = std::make_unique<SolvedCache>(options.cachePath);
+  }
+}
+
+void Game::handleOptionsClick() {
+  for (int i = 0; i < OptCount; i++) {
+    if (!insideRect(optionRects[i], mouseX, mouseY)) { continue; }
+
+    if (i == OptDone) {
+      currentMenu = MenuNone;
+    } else {
+      cycleOption(i);
+    }
+
+    render();
+    return;
+  }
 }
 
 void Game::drawGameOverMenu() {
@@ -221,8 +372,8 @@ void Game::drawGameOverMenu() {
   btnRects[BtnYes].w = BTN_W;
   btnRects[BtnYes].h = BTN_H;
 
-  SDL_RenderCopy(renderer, btnTextures[BtnNo], &clip[BtnNo], &btnRects[BtnNo]);
-  SDL_RenderCopy(renderer, btnTextures[BtnYes], &clip[BtnYes], &btnRects[BtnYes]);
+  SDL_RenderCopy(renderer, buttonTexture(BtnNo), &clip[BtnNo], &btnRects[BtnNo]);
+  SDL_RenderCopy(renderer, buttonTexture(BtnYes), &clip[BtnYes], &btnRects[BtnYes]);
 }
 
 void Game::drawDisc(Sint16 col, Sint16 row, int color) {
@@ -334,11 +485,32 @@ void Game::drawGrid() {
 
 void Game::newGame() {
   board = new Board();
+  record.clear();
   turn = DARK;
 }
 
+void Game::saveRecord() {
+  Position position = board->position();
+  record.setResult(position.count(DARK) - position.count(LIGHT));
+
+  GameRecordWriter writer(options.dataPath(RECORDS).c_str());
+  if (writer.isOpen())
+    writer.write(record);
+}
+
 void Game::handleClick(SDL_MouseButtonEvent *event) {
   switch (currentMenu) {
+    case MenuNone:
+      if (isPlayerTurn() && (event->button == SDL_BUTTON_RIGHT ||
+                             insideRect(btnRects[BtnOptions], mouseX, mouseY))) {
+        currentMenu = MenuOptions;
+        render();
+        return;
+      }
+      break;
+    case MenuOptions:
+      handleOptionsClick();
+      return;
     case MenuGameOver:
       if (insideRect(btnRects[BtnNo], mouseX, mouseY)) {
         currentMenu = MenuNone;
@@ -354,13 +526,14 @@ void Game::handleClick(SDL_MouseButtonEvent *event) {
       break;
   }
 
-  if (!isPlayerTurn() || event->button != SDL_BUTTON_LEFT) { return; }
+  if (!isPlayerTurn() || event->button != SDL_BUTTON_LEFT || mouseY >= SCREEN_W) { return; }
 
   int col = (mouseX - LABEL) / DISC;
   int row = (mouseY - LABEL) / DISC;
 
   if (board->legalMove(col, row, DARK)) {
     board->flipPieces(col, row, DARK);
+    record.addMove(Move(col, row));
     switchTurn();
     render();
 
@@ -397,8 +570,9 @@ void Game::switchTurn() {
     turn = DARK;
   } else if (isPlayerTurn() && lightCanGo) {
     turn = LIGHT;
-  } else if(!darkCanGo && !lightCanGo) {
+  } else if(!darkCanGo && !lightCanGo && currentMenu != MenuGameOver) {
     currentMenu = MenuGameOver;
+    saveRecord();
   }
 }
 
@@ -410,94 +584,18 @@ void Game::aiTurn() {
 
   if (m.col > -1 && m.row > -1) {
     board->flipPieces(m.col, m.row, LIGHT);
+    record.addMove(m);
   }
 }
 
-int Game::otherColor(int color) {
-  return color == DARK ? LIGHT : DARK;
-}
-
 Move Game::getAiMove() {
-  auto moves = board->legalMoves(LIGHT);
-  int eval;
-  int maxEval = std::numeric_limits<int>::min();
-  Move bestMove = Move(-1, -1);
-
-  for (auto &move : moves) {
-    auto childBoard = Board(*board);
-    childBoard.addMove(move, LIGHT);
-    eval = minimax(&childBoard, DEPTH, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), false);
-    if (eval > maxEval) {
-      maxEval = eval;
-      bestMove = move;
-    }
-  }
-
-  return bestMove;
-}
-
-int Game::minimax(Board *board, int depth, int alpha, int beta, bool maximizingPlayer) {
-
-  int maxColor = maximizingPlayer ? DARK : LIGHT;
-
-  if (depth == 0 || board->legalMoves(maxColor).empty()) {
-    return evaluate(board, maxColor);
-  }
-
-  int eval;
-
-  if (maximizingPlayer) {
-    int maxEval = std::numeric_limits<int>::min();
-
-    for (auto &move : board->legalMoves(LIGHT)) {
-      auto childBoard = Board(*board);
-      childBoard.addMove(move, LIGHT);
-      eval = minimax(&childBoard, depth - 1, alpha, beta, false);
-      maxEval = std::max(maxEval, eval);
-      alpha = std::max(alpha, eval);
-      if (beta <= alpha)
-        break;
-    }
+  Search search(&table, &book, options, cache.get());
+  Move move = search.bestMove(board, LIGHT);
 
-    return maxEval;
-
-  } else {
-    int minEval = std::numeric_limits<int>::max();
-
-    for (auto &move : board->legalMoves(DARK)) {
-      auto childBoard = Board(*board);
-      childBoard.addMove(move, DARK);
-      eval = minimax(&childBoard, depth - 1, alpha, beta, true);
-      minEval = std::min(minEval, eval);
-      beta = std::min(beta, eval);
-      if (beta <= alpha)
-        break;
-    }
-
-    return minEval;
-  }
-}
-
-int Game::evaluate(Board *board, int color) {
-  int other = otherColor(color);
-
-  int colorScore = board->getMovesScore(color) - board->getMovesScore(other);
-
-  int mobilityScore = (int)board->legalMoves(color).size() - (int)board->legalMoves(other).size();
-
-  int score = (colorScoreWeight(board) * colorScore) + (mobilityScoreWeight(board) * mobilityScore);
-
-  return color == DARK ? -score : score;
-}
-
-int Game::colorScoreWeight(Board *board) {
-  if (board->totalMoves == 0) { return 1; }
-  return board->totalMoves * 100;
-}
+  if (cache)
+    cache->flush();
 
-int Game::mobilityScoreWeight(Board *board) {
-  if (board->totalMoves == 0) { return 1; }
-  return 10000 / board->totalMoves;
+  return move;
 }
 
 void Game::writeText(const char *text, const int x, const int y, TTF_Font *font) {
@@ -0,0 +1,205 @@
+#include "GameRecord.h"
+#include "Board.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+RecordView::RecordView(const RecordHeader *header, const uint8_t *moves, const int16_t *evals)
+    : header(header), moves(moves), evals(evals) {}
+
+int RecordView::moveCount() const {
+  return header->moveCount;
+}
+
+bool RecordView::hasEvals() const {
+  return evals != nullptr;
+}
+
+Move RecordView::move(int ply) const {
+  return Move(moves[ply] % SIZE, moves[ply] / SIZE);
+}
+
+int RecordView::eval(int ply) const {
+  return evals ? evals[ply] : 0;
+}
+
+Position RecordView::positionAt(int ply, int *color) const {
+  Position position = Position::initial();
+  int turn = DARK;
+
+  for (int i = 0; i < ply && i < header->moveCount; i++) {
+    if (!position.legalMoves(turn))
+      turn = turn == DARK ? LIGHT : DARK;
+
+    if (moves[i] >= SIZE * SIZE || !(position.legalMoves(turn) & Position::bit(moves[i]))) { break; }
+
+    position.play(moves[i], turn);
+    turn = turn == DARK ? LIGHT : DARK;
+  }
+
+  if (!position.legalMoves(turn) && position.legalMoves(turn == DARK ? LIGHT : DARK))
+    turn = turn == DARK ? LIGHT : DARK;
+
+  if (color)
+    *color = turn;
+
+  return position;
+}
+
+size_t RecordView::size(const RecordHeader &header) {
+  size_t moveBytes = (header.moveCount + 1) & ~(size_t) 1;
+  size_t evalBytes = (header.flags & RECORD_EVALS) ? header.moveCount * sizeof(int16_t) : 0;
+  return sizeof(RecordHeader) + moveBytes + evalBytes;
+}
+
+GameRecord::GameRecord() : header() {
+  clear();
+}
+
+void GameRecord::clear() {
+  header.magic = RECORD_MAGIC;
+  header.version = RECORD_VERSION;
+  header.flags = 0;
+  header.moveCount = 0;
+  header.result = 0;
+  moves.clear();
+  evals.clear();
+}
+
+void GameRecord::addMove(const Move &move) {
+  moves.push_back((uint8_t) Position::square(move.col, move.row));
+  evals.push_back(0);
+  header.moveCount = (uint16_t) moves.size();
+}
+
+void GameRecord::addMove(const Move &move, int eval) {
+  addMove(move);
+  evals.back() = (int16_t) std::max(-32768, std::min(32767, eval));
+  header.flags |= RECORD_EVALS;
+}
+
+void GameRecord::setResult(int result) {
+  header.result = (int16_t) result;
+}
+
+void GameRecord::write(std::ostream &out) const {
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(moves.data()), (std::streamsize) moves.size());
+
+  if (moves.size() % 2)
+    out.put(0);
+
+  if (header.flags & RECORD_EVALS)
+    out.write(reinterpret_cast<const char *>(evals.data()), (std::streamsize) (evals.size() * sizeof(int16_t)));
+}
+
+RecordView GameRecord::view() const {
+  return RecordView(&header, moves.data(), (header.flags & RECORD_EVALS) ? evals.data() : nullptr);
+}
+
+GameRecordWriter::GameRecordWriter(const char *path) : out(path, std::ios::binary | std::ios::app) {}
+
+bool GameRecordWriter::isOpen() const {
+  return out.is_open();
+}
+
+void GameRecordWriter::write(const GameRecord &record) {
+  record.write(out);
+}
+
+void GameRecordWriter::flush() {
+  out.flush();
+}
+
+GameRecordFile::Iterator::Iterator(const uint8_t *pos, const uint8_t *end) : pos(pos), end(end) {
+  validate();
+}
+
+RecordView GameRecordFile::Iterator::operator*() const {
+  auto header = reinterpret_cast<const RecordHeader *>(pos);
+  const uint8_t *moves = pos + sizeof(RecordHeader);
+  const int16_t *evals = nullptr;
+
+  if (header->flags & RECORD_EVALS)
+    evals = reinterpret_cast<const int16_t *>(moves + ((header->moveCount + 1) & ~1));
+
+  return RecordView(header, moves, evals);
+}
+
+GameRecordFile::Iterator &GameRecordFile::Iterator::operator++() {
+  pos += RecordView::size(*reinterpret_cast<const RecordHeader *>(pos));
+  validate();
+  return *this;
+}
+
+bool GameRecordFile::Iterator::operator!=(const Iterator &other) const {
+  return pos != other.pos;
+}
+
+void GameRecordFile::Iterator::validate() {
+  if (pos == end) { return; }
+
+  auto header = reinterpret_cast<const RecordHeader *>(pos);
+
+  if ((size_t) (end - pos) < sizeof(RecordHeader) ||
+      header->magic != RECORD_MAGIC ||
+      header->version != RECORD_VERSION ||
+      RecordView::size(*header) > (size_t) (end - pos)) {
+    pos = end;
+    return;
+  }
+
+  const uint8_t *moves = pos + sizeof(RecordHeader);
+  for (int i = 0; i < header->moveCount; i++)
+    if (moves[i] >= SIZE * SIZE) {
+      pos = end;
+      return;
+    }
+}
+
+GameRecordFile::GameRecordFile(const char *path) {
+#ifndef _WIN32
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) { return; }
+
+  struct stat st{};
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    void *p = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED) {
+      data = static_cast<const uint8_t *>(p);
+      length = (size_t) st.st_size;
+      mapped = true;
+    }
+  }
+
+  close(fd);
+#else
+  std::ifstream in(path, std::ios::binary);
+  buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  data = buffer.data();
+  length = buffer.size();
+#endif
+}
+
+GameRecordFile::~GameRecordFile() {
+#ifndef _WIN32
+  if (mapped)
+    munmap(const_cast<uint8_t *>(data), length);
+#endif
+}
+
+bool GameRecordFile::isOpen() const {
+  return data != nullptr;
+}
+
+GameRecordFile::Iterator GameRecordFile::begin() const {
+  return Iterator(data, data + length);
+}
+
+GameRecordFile::Iterator GameRecordFile::end() const {
+  return Iterator(data + length, data + length);
+}
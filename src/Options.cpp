@@ -0,0 +1,109 @@
+#include "Options.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+const char *Options::names[] = {"time", "depth", "threads", "hash", "book", "weights", "cache", nullptr};
+
+static bool parseInt(const std::string &value, int min, int max, int *out) {
+  try {
+    size_t used;
+    int v = std::stoi(value, &used);
+    if (used != value.size() || v < min || v > max) { return false; }
+    *out = v;
+    return true;
+  } catch (const std::exception &) {
+    return false;
+  }
+}
+
+bool Options::set(const std::string &name, const std::string &value) {
+  if (name == "time") { return parseInt(value, 0, 3600000, &timePerMove); }
+  if (name == "depth") { return parseInt(value, 1, 60, &depth); }
+  if (name == "threads") { return parseInt(value, 1, 256, &threads); }
+  if (name == "hash") { return parseInt(value, 1, 65536, &hashSize); }
+
+  if (name == "book") {
+    if (value == "on" || value == "true" || value == "1") { useBook = true; return true; }
+    if (value == "off" || value == "false" || value == "0") { useBook = false; return true; }
+    return false;
+  }
+
+  if (name == "weights") {
+    evalWeights = value;
+    return true;
+  }
+
+  if (name == "cache") {
+    cachePath = value == "off" ? "" : value == "on" ? CACHE_FILE : value;
+    return true;
+  }
+
+  return false;
+}
+
+std::string Options::get(const std::string &name) const {
+  if (name == "time") { return std::to_string(timePerMove); }
+  if (name == "depth") { return std::to_string(depth); }
+  if (name == "threads") { return std::to_string(threads); }
+  if (name == "hash") { return std::to_string(hashSize); }
+  if (name == "book") { return useBook ? "on" : "off"; }
+  if (name == "weights") { return evalWeights; }
+  if (name == "cache") { return cachePath.empty() ? "off" : cachePath; }
+  return "";
+}
+
+std::string Options::dataPath(const char *name) const {
+  return baseDir + name;
+}
+
+bool Options::load(const char *path) {
+  std::ifstream in(path);
+  if (!in) { return false; }
+
+  std::string line;
+  int lineNo = 0;
+
+  while (std::getline(in, line)) {
+    lineNo++;
+    line.erase(std::find(line.begin(), line.end(), '#'), line.end());
+
+    auto eq = line.find('=');
+    if (eq == std::string::npos) { continue; }
+
+    auto trim = [](std::string s) {
+      s.erase(0, s.find_first_not_of(" \t\r"));
+      s.erase(s.find_last_not_of(" \t\r") + 1);
+      return s;
+    };
+
+    std::string name = trim(line.substr(0, eq));
+    std::string value = trim(line.substr(eq + 1));
+
+    if (!set(name, value))
+      std::cout << path << ":" << lineNo << ": invalid option: " << name << " = " << value << std::endl;
+  }
+
+  return true;
+}
+
+void Options::parseArgs(int argc, char *argv[]) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.rfind("--", 0) != 0) { continue; }
+
+    auto eq = arg.find('=');
+    if (eq == std::string::npos) { continue; }
+
+    std::string name = arg.substr(2, eq - 2);
+    std::string value = arg.substr(eq + 1);
+
+    if (name == "config") {
+      if (!load(value.c_str()))
+        std::cout << "Unable to read config " << value << std::endl;
+    } else if (!set(name, value)) {
+      std::cout << "Invalid option: " << arg << std::endl;
+    }
+  }
+}
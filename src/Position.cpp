@@ -0,0 +1,355 @@
+#include "Position.h"
+
+#include <random>
+
+template<int N>
+struct Layout {
+  typedef typename BasicPosition<N>::Mask Mask;
+
+  static constexpr Mask column(int col) {
+    Mask mask = 0;
+    for (int row = 0; row < N; row++)
+      mask |= (Mask) 1 << (row * N + col);
+    return mask;
+  }
+
+  static constexpr Mask row(int row) {
+    return (((Mask) 1 << N) - 1) << (row * N);
+  }
+
+  static constexpr Mask full = N * N == (int) sizeof(Mask) * 8 ? ~(Mask) 0 : ((Mask) 1 << (N * N)) - 1;
+  static constexpr Mask notA = full & ~column(0);
+  static constexpr Mask notH = full & ~column(N - 1);
+  static constexpr Mask sides = column(0) | column(N - 1);
+  static constexpr Mask ends = row(0) | row(N - 1);
+};
+
+template<int N>
+static inline typename BasicPosition<N>::Mask shift(typename BasicPosition<N>::Mask b, int dir) {
+  typedef Layout<N> L;
+
+  switch (dir) {
+    case 0: return (b >> (N + 1)) & L::notH;
+    case 1: return b >> N;
+    case 2: return (b >> (N - 1)) & L::notA;
+    case 3: return (b << 1) & L::notA;
+    case 4: return (b << (N + 1)) & L::notA;
+    case 5: return (b << N) & L::full;
+    case 6: return (b << (N - 1)) & L::notH;
+    default: return (b >> 1) & L::notH;
+  }
+}
+
+static inline uint64_t flipVertical(uint64_t b) {
+  return __builtin_bswap64(b);
+}
+
+static inline uint64_t mirrorHorizontal(uint64_t b) {
+  b = ((b >> 1) & 0x5555555555555555ULL) | ((b & 0x5555555555555555ULL) << 1);
+  b = ((b >> 2) & 0x3333333333333333ULL) | ((b & 0x3333333333333333ULL) << 2);
+  b = ((b >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((b & 0x0f0f0f0f0f0f0f0fULL) << 4);
+  return b;
+}
+
+static inline uint64_t flipDiagonal(uint64_t b) {
+  uint64_t t;
+  t = 0x0f0f0f0f00000000ULL & (b ^ (b << 28));
+  b ^= t ^ (t >> 28);
+  t = 0x3333000033330000ULL & (b ^ (b << 14));
+  b ^= t ^ (t >> 14);
+  t = 0x5500550055005500ULL & (b ^ (b << 7));
+  b ^= t ^ (t >> 7);
+  return b;
+}
+
+static inline uint64_t mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+template<int N>
+struct Lines {
+  typedef typename BasicPosition<N>::Mask Mask;
+
+  Mask masks[4][2 * N - 1]{};
+  int count[4]{N, N, 2 * N - 1, 2 * N - 1};
+
+  Lines() {
+    for (int row = 0; row < N; row++)
+      for (int col = 0; col < N; col++) {
+        Mask bit = BasicPosition<N>::bit(BasicPosition<N>::square(col, row));
+        masks[0][row] |= bit;
+        masks[1][col] |= bit;
+        masks[2][col - row + N - 1] |= bit;
+        masks[3][col + row] |= bit;
+      }
+  }
+};
+
+template<int N>
+static typename BasicPosition<N>::Mask fullLines(typename BasicPosition<N>::Mask filled, int pair) {
+  static const Lines<N> lines;
+  typename BasicPosition<N>::Mask full = 0;
+
+  for (int i = 0; i < lines.count[pair]; i++)
+    if ((filled & lines.masks[pair][i]) == lines.masks[pair][i])
+      full |= lines.masks[pair][i];
+
+  return full;
+}
+
+template<int N>
+BasicPosition<N>::BasicPosition() : dark(0), light(0) {}
+
+template<int N>
+BasicPosition<N>::BasicPosition(Mask dark, Mask light) : dark(dark), light(light) {}
+
+template<int N>
+BasicPosition<N> BasicPosition<N>::initial() {
+  int m = N / 2;
+  BasicPosition position;
+  position.light = bit(square(m - 1, m - 1)) | bit(square(m, m));
+  position.dark = bit(square(m - 1, m)) | bit(square(m, m - 1));
+  return position;
+}
+
+template<int N>
+BasicPosition<N> BasicPosition<N>::random(unsigned seed, int plies, int *color) {
+  std::mt19937 rng(seed);
+  BasicPosition position = initial();
+  int turn = DARK;
+
+  for (int ply = 0; ply < plies; ply++) {
+    Mask moves = position.legalMoves(turn);
+    if (!moves) {
+      turn = turn == DARK ? LIGHT : DARK;
+      moves = position.legalMoves(turn);
+      if (!moves) { break; }
+    }
+
+    for (int k = (int) (rng() % (unsigned) bitCount(moves)); k > 0; k--)
+      moves &= moves - 1;
+    position.play(firstSquare(moves), turn);
+    turn = turn == DARK ? LIGHT : DARK;
+  }
+
+  if (!position.legalMoves(turn))
+    turn = turn == DARK ? LIGHT : DARK;
+
+  *color = turn;
+  return position;
+}
+
+template<int N>
+int BasicPosition<N>::square(int col, int row) {
+  return row * N + col;
+}
+
+template<int N>
+int BasicPosition<N>::getColor(int col, int row) const {
+  Mask b = bit(square(col, row));
+  if (dark & b) { return DARK; }
+  if (light & b) { return LIGHT; }
+  return EMPTY;
+}
+
+template<int N>
+int BasicPosition<N>::count(int color) const {
+  return bitCount(discs(color));
+}
+
+template<int N>
+int BasicPosition<N>::empties() const {
+  return N * N - bitCount(dark | light);
+}
+
+template<int N>
+typename BasicPosition<N>::Mask BasicPosition<N>::discs(int color) const {
+  return color == DARK ? dark : light;
+}
+
+template<int N>
+typename BasicPosition<N>::Mask BasicPosition<N>::legalMoves(int color) const {
+  Mask mine = discs(color);
+  Mask theirs = discs(color == DARK ? LIGHT : DARK);
+  Mask empty = Layout<N>::full & ~(dark | light);
+  Mask moves = 0;
+
+  for (int dir = 0; dir < 8; dir++) {
+    Mask x = shift<N>(mine, dir) & theirs;
+    for (int i = 0; i < N - 3; i++)
+      x |= shift<N>(x, dir) & theirs;
+    moves |= shift<N>(x, dir) & empty;
+  }
+
+  return moves;
+}
+
+template<int N>
+typename BasicPosition<N>::Mask BasicPosition<N>::flips(int square, int color) const {
+  Mask mine = discs(color);
+  Mask theirs = discs(color == DARK ? LIGHT : DARK);
+  Mask flipped = 0;
+
+  for (int dir = 0; dir < 8; dir++) {
+    Mask line = 0;
+    Mask b = shift<N>(bit(square), dir);
+
+    while (b & theirs) {
+      line |= b;
+      b = shift<N>(b, dir);
+    }
+
+    if (b & mine)
+      flipped |= line;
+  }
+
+  return flipped;
+}
+
+template<int N>
+void BasicPosition<N>::play(int square, int color) {
+  Mask f = flips(square, color);
+  Mask b = bit(square);
+
+  if (color == DARK) {
+    dark |= f | b;
+    light &= ~f;
+  } else {
+    light |= f | b;
+    dark &= ~f;
+  }
+}
+
+template<int N>
+typename BasicPosition<N>::Mask BasicPosition<N>::stable(int color) const {
+  typedef Layout<N> L;
+  static const int pairs[4][2] = {{3, 7}, {1, 5}, {0, 4}, {2, 6}};
+  static const Mask edges[4] = {L::sides, L::ends, L::sides | L::ends, L::sides | L::ends};
+
+  Mask mine = discs(color);
+  Mask filled = dark | light;
+  Mask anchored[4];
+
+  for (int p = 0; p < 4; p++)
+    anchored[p] = fullLines<N>(filled, p) | edges[p];
+
+  Mask stable = 0;
+  Mask prev;
+
+  do {
+    prev = stable;
+    Mask candidates = mine;
+
+    for (int p = 0; p < 4; p++)
+      candidates &= anchored[p] | shift<N>(stable, pairs[p][0]) | shift<N>(stable, pairs[p][1]);
+
+    stable |= candidates;
+  } while (stable != prev);
+
+  return stable;
+}
+
+template<int N>
+bool BasicPosition<N>::operator==(const BasicPosition &other) const {
+  return dark == other.dark && light == other.light;
+}
+
+template<int N>
+bool BasicPosition<N>::operator!=(const BasicPosition &other) const {
+  return !(*this == other);
+}
+
+template<int N>
+typename BasicPosition<N>::Mask BasicPosition<N>::transform(Mask mask, int symmetry) {
+  if constexpr (N == 8) {
+    if (symmetry & SYM_DIAGONAL) { mask = flipDiagonal(mask); }
+    if (symmetry & SYM_VERTICAL) { mask = flipVertical(mask); }
+    if (symmetry & SYM_HORIZONTAL) { mask = mirrorHorizontal(mask); }
+    return mask;
+  } else {
+    Mask out = 0;
+
+    while (mask) {
+      int sq = firstSquare(mask);
+      mask &= mask - 1;
+      out |= bit(transformSquare(sq, symmetry));
+    }
+
+    return out;
+  }
+}
+
+template<int N>
+int BasicPosition<N>::transformSquare(int square, int symmetry) {
+  if constexpr (N == 8) {
+    return firstSquare(transform(bit(square), symmetry));
+  } else {
+    int col = square % N;
+    int row = square / N;
+    if (symmetry & SYM_DIAGONAL) { std::swap(col, row); }
+    if (symmetry & SYM_VERTICAL) { row = N - 1 - row; }
+    if (symmetry & SYM_HORIZONTAL) { col = N - 1 - col; }
+    return BasicPosition::square(col, row);
+  }
+}
+
+template<int N>
+int BasicPosition<N>::inverse(int symmetry) {
+  if (!(symmetry & SYM_DIAGONAL)) { return symmetry; }
+
+  int inv = SYM_DIAGONAL;
+  if (symmetry & SYM_VERTICAL) { inv |= SYM_HORIZONTAL; }
+  if (symmetry & SYM_HORIZONTAL) { inv |= SYM_VERTICAL; }
+  return inv;
+}
+
+template<int N>
+BasicPosition<N> BasicPosition<N>::transformed(int symmetry) const {
+  return BasicPosition(transform(dark, symmetry), transform(light, symmetry));
+}
+
+template<int N>
+BasicPosition<N> BasicPosition<N>::canonical(int *symmetry) const {
+  BasicPosition best = *this;
+  int bestSymmetry = 0;
+
+  for (int s = 1; s < SYMMETRIES; s++) {
+    BasicPosition p = transformed(s);
+    if (p.dark < best.dark || (p.dark == best.dark && p.light < best.light)) {
+      best = p;
+      bestSymmetry = s;
+    }
+  }
+
+  if (symmetry)
+    *symmetry = bestSymmetry;
+
+  return best;
+}
+
+template<int N>
+uint64_t BasicPosition<N>::hash() const {
+  if constexpr (sizeof(Mask) == sizeof(uint64_t)) {
+    return mix(dark ^ mix(light + 0x9e3779b97f4a7c15ULL));
+  } else {
+    uint64_t h = mix((uint64_t) (light >> 64) + 0x9e3779b97f4a7c15ULL);
+    h = mix((uint64_t) light ^ h);
+    h = mix((uint64_t) (dark >> 64) ^ h);
+    return mix((uint64_t) dark ^ h);
+  }
+}
+
+template<int N>
+uint64_t BasicPosition<N>::key(int color, int *symmetry) const {
+  uint64_t h = canonical(symmetry).hash();
+  return color == DARK ? h : ~h;
+}
+
+template class BasicPosition<6>;
+template class BasicPosition<8>;
+template class BasicPosition<10>;
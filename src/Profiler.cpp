@@ -0,0 +1,258 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "Bench.h"
+#include "Board.h"
+#include "Search.h"
+#include "TranspositionTable.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define CALIBRATION 20000
+
+const char *Profiler::pointNames[ProfilePoints] = {"legalMoves", "flipPieces", "evaluate", "search"};
+
+const char *Profiler::counterNames[Counters] = {"cycles", "instructions", "branchMisses", "l1Misses", "llcMisses"};
+
+static thread_local bool active = false;
+static thread_local long guardCount = 0;
+static int leader = -1;
+static int fds[Counters] = {-1, -1, -1, -1, -1};
+static int slots[Counters] = {-1, -1, -1, -1, -1};
+static std::string reason;
+static double overhead[Counters + 1];
+static ProfileTotals totals[ProfilePoints];
+
+static void calibrate() {
+  ProfileSample start{}, end{}, scratch{};
+
+  Profiler::sample(&start);
+  for (int i = 0; i < CALIBRATION; i++)
+    Profiler::sample(&scratch);
+  Profiler::sample(&end);
+
+  for (int c = 0; c < Counters; c++)
+    overhead[c] = (double) (end.counts[c] - start.counts[c]) / (CALIBRATION + 1);
+  overhead[Counters] = (double) (end.nanos - start.nanos) / (CALIBRATION + 1);
+}
+
+bool Profiler::open() {
+  close();
+
+#ifdef __linux__
+  const struct {
+    uint32_t type;
+    uint64_t config;
+  } events[Counters] = {
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+      {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+      {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+  };
+
+  int opened = 0;
+
+  for (int c = 0; c < Counters; c++) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = events[c].type;
+    attr.config = events[c].config;
+    attr.disabled = leader < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    int fd = (int) syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+    if (fd < 0) {
+      if (reason.empty()) { reason = std::string(counterNames[c]) + ": " + strerror(errno); }
+      continue;
+    }
+
+    if (leader < 0) { leader = fd; }
+    fds[c] = fd;
+    slots[c] = opened++;
+  }
+
+  if (leader >= 0) {
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+#else
+  reason = "perf_event_open needs Linux";
+#endif
+
+  active = true;
+  calibrate();
+  reset();
+  return leader >= 0;
+}
+
+void Profiler::close() {
+#ifdef __linux__
+  for (int c = 0; c < Counters; c++) {
+    if (fds[c] >= 0) { ::close(fds[c]); }
+    fds[c] = -1;
+    slots[c] = -1;
+  }
+#endif
+
+  leader = -1;
+  active = false;
+}
+
+bool Profiler::available(int counter) {
+  return slots[counter] >= 0;
+}
+
+void Profiler::sample(ProfileSample *sample) {
+  if (!active) { return; }
+
+  sample->guards = guardCount;
+  sample->nanos = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+
+  uint64_t values[1 + Counters] = {};
+#ifdef __linux__
+  if (leader >= 0 && ::read(leader, values, sizeof(values)) < 0)
+    values[0] = 0;
+#endif
+
+  for (int c = 0; c < Counters; c++)
+    sample->counts[c] = slots[c] >= 0 ? values[1 + slots[c]] : 0;
+}
+
+void Profiler::add(int point, const ProfileSample &start) {
+  if (!active) { return; }
+
+  ProfileSample end{};
+  sample(&end);
+
+  // One read of our own falls inside the span, plus both reads of every
+  // guard nested in it.
+  double reads = 2.0 * (double) (end.guards - start.guards) + 1.0;
+  ProfileTotals &total = totals[point];
+
+  total.calls++;
+  total.nanos += std::max(0.0, (double) (end.nanos - start.nanos) - reads * overhead[Counters]);
+  for (int c = 0; c < Counters; c++)
+    total.counts[c] += std::max(0.0, (double) (end.counts[c] - start.counts[c]) - reads * overhead[c]);
+
+  guardCount++;
+}
+
+void Profiler::reset() {
+  for (auto &total : totals)
+    total = ProfileTotals{};
+}
+
+static void printRow(const char *name, long calls, const ProfileTotals &total, double per) {
+  printf("%-12s %10ld %10.1f", name, calls, total.nanos / per);
+
+  for (int c = 0; c < Counters; c++) {
+    if (Profiler::available(c)) {
+      printf(" %12.1f", total.counts[c] / per);
+    } else {
+      printf(" %12s", "-");
+    }
+
+    if (c == CounterInstructions) {
+      if (Profiler::available(CounterCycles) && Profiler::available(CounterInstructions) && total.counts[CounterCycles] > 0) {
+        printf(" %6.2f", total.counts[CounterInstructions] / total.counts[CounterCycles]);
+      } else {
+        printf(" %6s", "-");
+      }
+    }
+  }
+
+  printf("\n");
+}
+
+void Profiler::report(long nodes) {
+  if (leader < 0)
+    printf("hardware counters unavailable (%s), showing wall time only\n", reason.c_str());
+  else if (!reason.empty())
+    printf("some counters unavailable (%s)\n", reason.c_str());
+
+  printf("%-12s %10s %10s %12s %12s %6s %12s %12s %12s\n", "per call", "calls", "ns", "cycles", "instructions",
+         "ipc", "br-misses", "l1d-misses", "llc-misses");
+
+  for (int p = 0; p < ProfilePoints; p++)
+    if (totals[p].calls)
+      printRow(pointNames[p], totals[p].calls, totals[p], (double) totals[p].calls);
+
+  if (nodes > 0)
+    printRow("search/node", nodes, totals[ProfileSearch], (double) nodes);
+}
+
+static void writeCounts(std::ofstream &out, const ProfileTotals &total, double per) {
+  out << "\"ns\": " << total.nanos / per;
+
+  for (int c = 0; c < Counters; c++) {
+    out << ", \"" << Profiler::counterNames[c] << "\": ";
+    if (Profiler::available(c)) {
+      out << total.counts[c] / per;
+    } else {
+      out << "null";
+    }
+  }
+}
+
+bool Profiler::writeJson(const char *path, long nodes) {
+  std::ofstream out(path);
+  if (!out.is_open()) { return false; }
+
+  out << "{\n  \"available\": " << (leader >= 0 ? "true" : "false") << ",\n";
+  out << "  \"reason\": \"" << reason << "\",\n";
+  out << "  \"nodes\": " << nodes << ",\n";
+  out << "  \"perCall\": {\n";
+
+  bool first = true;
+  for (int p = 0; p < ProfilePoints; p++) {
+    if (!totals[p].calls) { continue; }
+
+    out << (first ? "" : ",\n") << "    \"" << pointNames[p] << "\": {\"calls\": " << totals[p].calls << ", ";
+    writeCounts(out, totals[p], (double) totals[p].calls);
+    out << "}";
+    first = false;
+  }
+
+  out << "\n  },\n  \"perNode\": {";
+  writeCounts(out, totals[ProfileSearch], (double) std::max(1L, nodes));
+  out << "}\n}\n";
+  return true;
+}
+
+int Profiler::bench(const Options &options, int searches) {
+  Options searchOptions = Bench::searchOptions(options);
+  TranspositionTable table(options.hashSize);
+
+  open();
+  long nodes = 0;
+
+  for (auto &bench : Bench::positions(searches)) {
+    Board board(bench.position);
+    Search search(&table, nullptr, searchOptions);
+    search.bestMove(&board, bench.color);
+    nodes += search.nodes();
+  }
+
+  printf("%d searches, depth %d, %ld nodes\n", searches, options.depth, nodes);
+  report(nodes);
+
+  if (writeJson(PROFILE_JSON, nodes))
+    printf("wrote %s\n", PROFILE_JSON);
+
+  close();
+  return EXIT_SUCCESS;
+}
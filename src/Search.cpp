@@ -0,0 +1,657 @@
+#include "Search.h"
+#include "Profiler.h"
+
+template<int N>
+BasicSearch<N>::BasicSearch(TranspositionTable *table, Book *book, const Options &options, SolvedCache *cache)
+    : table(table), book(book), cache(cache), cacheTag(evalTag()), options(options), started(std::chrono::steady_clock::now()) {}
+
+template<int N>
+EvalCache BasicSearch<N>::evalCache;
+
+template<int N>
+Move BasicSearch<N>::bestMove(Board *board, int color) {
+  PROFILE_SCOPE(ProfileSearch);
+  started = std::chrono::steady_clock::now();
+  std::vector<Move> roots;
+  Move bestMove(-1, -1);
+
+  if (prepareRoots(board, color, roots, &bestMove)) { return bestMove; }
+
+  std::vector<int> scores(roots.size());
+
+  for (int depth = 1; depth <= options.depth; depth++) {
+    searchRoots(board, color, depth, roots, scores);
+    if (stopped) { break; }
+
+    pickBest(color, depth, roots, scores, &bestMove);
+  }
+
+  return bestMove;
+}
+
+template<int N>
+std::vector<PVLine> BasicSearch<N>::analyze(Board *board, int color, int lines, const AnalysisCallback &callback) {
+  started = std::chrono::steady_clock::now();
+  deadline = started + std::chrono::milliseconds(options.timePerMove);
+  stopped = false;
+
+  std::vector<Move> roots = board->legalMoves(color);
+  std::vector<PVLine> result;
+  std::vector<PVLine> ranked;
+  lines = std::max(1, std::min(lines, (int) roots.size()));
+
+  for (int depth = 1; depth <= options.depth && !roots.empty(); depth++) {
+    ranked.clear();
+
+    for (auto &root : roots) {
+      auto childBoard = Board(*board);
+      childBoard.flipPieces(root.col, root.row, color);
+
+      bool full = (int) ranked.size() == lines;
+      int alpha = std::numeric_limits<int>::min();
+      int beta = std::numeric_limits<int>::max();
+
+      if (full && color == LIGHT) { alpha = ranked.back().score; }
+      if (full && color == DARK) { beta = -ranked.back().score; }
+
+      int value = minimax(&childBoard, depth, alpha, beta, color == DARK);
+      if (stopped) { break; }
+
+      int score = color == LIGHT ? value : -value;
+      if (full && score <= ranked.back().score) { continue; }
+
+      auto at = std::find_if(ranked.begin(), ranked.end(), [score](const PVLine &line) { return line.score < score; });
+      std::vector<Move> pv = principalVariation(childBoard.position(), otherColor(color), depth);
+      pv.insert(pv.begin(), root);
+      ranked.insert(at, PVLine{root, score, pv});
+      if ((int) ranked.size() > lines) { ranked.pop_back(); }
+
+      if (callback)
+        callback(depth, ranked);
+    }
+
+    if (stopped) { break; }
+
+    result = ranked;
+    bestScore = color == LIGHT ? result.front().score : -result.front().score;
+    depthReached = depth;
+
+    std::vector<Move> ordered;
+    for (auto &line : result)
+      ordered.push_back(line.move);
+    for (auto &root : roots)
+      if (std::none_of(result.begin(), result.end(), [&root](const PVLine &line) {
+            return line.move.col == root.col && line.move.row == root.row;
+          }))
+        ordered.push_back(root);
+    roots.swap(ordered);
+  }
+
+  return result.empty() ? ranked : result;
+}
+
+template<int N>
+std::vector<Move> BasicSearch<N>::principalVariation(Position position, int color, int length) {
+  std::vector<Move> pv;
+
+  while ((int) pv.size() < length) {
+    if (!position.legalMoves(color)) {
+      color = otherColor(color);
+      if (!position.legalMoves(color)) { break; }
+    }
+
+    int symmetry;
+    TTEntry entry{};
+    if (!table->probe(position.key(color, &symmetry), &entry) || entry.move == NO_SQUARE) { break; }
+
+    int square = Position::transformSquare(entry.move, Position::inverse(symmetry));
+    if (!(position.legalMoves(color) & Position::bit(square))) { break; }
+
+    position.play(square, color);
+    pv.emplace_back(square % N, square / N);
+    color = otherColor(color);
+  }
+
+  return pv;
+}
+
+template<int N>
+Task<Move> BasicSearch<N>::bestMoveTask(Board board, int color) {
+  std::vector<Move> roots;
+  Move bestMove(-1, -1);
+
+  if (prepareRoots(&board, color, roots, &bestMove)) { co_return bestMove; }
+
+  std::vector<int> scores(roots.size());
+
+  for (int depth = 1; depth <= options.depth; depth++) {
+    for (size_t i = 0; i < roots.size() && !stopped; i++) {
+      Position child = board.position();
+      child.play(Position::square(roots[i].col, roots[i].row), color);
+      scores[i] = co_await minimaxTask(child, depth, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), color == DARK);
+    }
+    if (stopped) { break; }
+
+    pickBest(color, depth, roots, scores, &bestMove);
+  }
+
+  co_return bestMove;
+}
+
+template<int N>
+bool BasicSearch<N>::prepareRoots(Board *board, int color, std::vector<Move> &roots, Move *move) {
+  if constexpr (N == SIZE) {
+    if (options.useBook && book) {
+      Move bookMove = book->probe(board->position(), color);
+      if (bookMove.col > -1 && board->legalMove(bookMove.col, bookMove.row, color)) {
+        *move = bookMove;
+        return true;
+      }
+    }
+  }
+
+  std::vector<uint64_t> searched;
+
+  for (auto &legal : board->legalMoves(color)) {
+    auto childBoard = Board(*board);
+    childBoard.flipPieces(legal.col, legal.row, color);
+
+    uint64_t key = childBoard.position().key(otherColor(color));
+    if (std::find(searched.begin(), searched.end(), key) != searched.end())
+      continue;
+    searched.push_back(key);
+    roots.push_back(legal);
+  }
+
+  if (roots.size() <= 1) {
+    if (!roots.empty()) { *move = roots.front(); }
+    return true;
+  }
+
+  deadline = started + std::chrono::milliseconds(options.timePerMove);
+  stopped = false;
+  *move = roots.front();
+  return false;
+}
+
+template<int N>
+void BasicSearch<N>::pickBest(int color, int depth, std::vector<Move> &roots, const std::vector<int> &scores, Move *move) {
+  size_t best = 0;
+  for (size_t i = 1; i < roots.size(); i++)
+    if (color == LIGHT ? scores[i] > scores[best] : scores[i] < scores[best])
+      best = i;
+
+  *move = roots[best];
+  bestScore = scores[best];
+  depthReached = depth;
+  std::rotate(roots.begin(), roots.begin() + (long) best, roots.begin() + (long) best + 1);
+}
+
+template<int N>
+void BasicSearch<N>::searchRoots(Board *board, int color, int depth, const std::vector<Move> &roots, std::vector<int> &scores) {
+  std::atomic<size_t> next{0};
+
+  auto worker = [&]() {
+    for (size_t i = next++; i < roots.size(); i = next++) {
+      auto childBoard = Board(*board);
+      childBoard.flipPieces(roots[i].col, roots[i].row, color);
+      scores[i] = minimax(&childBoard, depth, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), color == DARK);
+    }
+  };
+
+  std::vector<std::thread> helpers;
+  int count = std::min(options.threads, (int) roots.size());
+
+  for (int i = 1; i < count; i++)
+    helpers.emplace_back(worker);
+
+  worker();
+
+  for (auto &t : helpers)
+    t.join();
+}
+
+template<int N>
+bool BasicSearch<N>::timeUp(bool force) {
+  long n = nodeCount.fetch_add(1, std::memory_order_relaxed);
+
+  if (options.timePerMove > 0 && (force || (n & (TIME_CHECK - 1)) == 0) && std::chrono::steady_clock::now() >= deadline)
+    stopped = true;
+
+  return stopped;
+}
+
+template<int N>
+long BasicSearch<N>::nodes() const {
+  return nodeCount;
+}
+
+template<int N>
+long BasicSearch<N>::evalHits() const {
+  return hitCount;
+}
+
+template<int N>
+long BasicSearch<N>::lazyEvals() const {
+  return lazyCount;
+}
+
+template<int N>
+long BasicSearch<N>::fullEvals() const {
+  return fullCount;
+}
+
+template<int N>
+int BasicSearch<N>::otherColor(int color) {
+  return color == DARK ? LIGHT : DARK;
+}
+
+template<int N>
+bool BasicSearch<N>::probe(uint64_t key, int symmetry, int depth, int &alpha, int &beta, int *ttMove, int *value) {
+  TTEntry entry{};
+  bool found = table->probe(key, &entry);
+
+  if (cache && depth >= CACHE_MIN_DEPTH && (!found || entry.depth < depth)) {
+    TTEntry cached{};
+    if (cache->probe(key, cacheTag, &cached) && (!found || cached.depth > entry.depth)) {
+      table->store(key, cached.value, cached.depth, cached.flag, cached.move);
+      entry = cached;
+      found = true;
+    }
+  }
+
+  if (!found) { return false; }
+
+  if (entry.move != NO_SQUARE)
+    *ttMove = Position::transformSquare(entry.move, Position::inverse(symmetry));
+
+  if (entry.depth >= depth) {
+    *value = entry.value;
+    if (entry.flag == TT_EXACT) { return true; }
+    if (entry.flag == TT_LOWER) { alpha = std::max(alpha, (int) entry.value); }
+    if (entry.flag == TT_UPPER) { beta = std::min(beta, (int) entry.value); }
+    if (beta <= alpha) { return true; }
+  }
+
+  return false;
+}
+
+template<int N>
+void BasicSearch<N>::store(uint64_t key, int symmetry, int depth, int alphaOrig, int betaOrig, int best, int bestSquare) {
+  int flag = TT_EXACT;
+  if (best <= alphaOrig) { flag = TT_UPPER; }
+  else if (best >= betaOrig) { flag = TT_LOWER; }
+
+  if (bestSquare != NO_SQUARE)
+    bestSquare = Position::transformSquare(bestSquare, symmetry);
+
+  table->store(key, best, depth, flag, bestSquare);
+
+  if (cache && depth >= CACHE_MIN_DEPTH)
+    cache->store(key, cacheTag, best, depth, flag, bestSquare);
+}
+
+// The search's move generation and move making, under the profiler's
+// legalMoves and flipPieces points.
+template<int N>
+static typename BasicPosition<N>::Mask generateMoves(const BasicPosition<N> &position, int color) {
+  PROFILE_SCOPE(ProfileLegalMoves);
+  return position.legalMoves(color);
+}
+
+template<int N>
+static void playMove(BasicPosition<N> &position, int square, int color) {
+  PROFILE_SCOPE(ProfileFlipPieces);
+  position.play(square, color);
+}
+
+// The table's move first, then the rest in square order.
+template<int N>
+static int nextSquare(typename BasicPosition<N>::Mask &moves, int ttMove) {
+  int square = ttMove != NO_SQUARE && (moves & BasicPosition<N>::bit(ttMove)) ? ttMove : BasicPosition<N>::firstSquare(moves);
+  moves &= ~BasicPosition<N>::bit(square);
+  return square;
+}
+
+template<int N>
+int BasicSearch<N>::minimax(Board *board, int depth, int alpha, int beta, bool maximizingPlayer) {
+  return minimax(board->position(), depth, alpha, beta, maximizingPlayer);
+}
+
+template<int N>
+int BasicSearch<N>::minimax(const Position &position, int depth, int alpha, int beta, bool maximizingPlayer) {
+
+  bool endgame = position.empties() <= ENDGAME_EMPTIES;
+
+  // An exact solve costs far more than one node, so check the clock before each.
+  if (timeUp(endgame)) { return 0; }
+
+  if (endgame) {
+    return solveEndgame(position, alpha, beta, maximizingPlayer);
+  }
+
+  int maxColor = maximizingPlayer ? DARK : LIGHT;
+
+  if (depth == 0) {
+    return evaluateLeaf(position, maxColor, alpha, beta);
+  }
+
+  int color = maximizingPlayer ? LIGHT : DARK;
+  Mask moves = generateMoves(position, color);
+
+  // Nothing reaches the table until the side to move has a move: a pass
+  // is searched as the other side's turn, and a finished game is scored.
+  if (!moves) {
+    if (!generateMoves(position, maxColor)) { return finalValue(position); }
+    return minimax(position, depth, alpha, beta, !maximizingPlayer);
+  }
+
+  int symmetry;
+  uint64_t key = position.key(color, &symmetry);
+  int alphaOrig = alpha;
+  int betaOrig = beta;
+  int ttMove = NO_SQUARE;
+  int value;
+
+  if (probe(key, symmetry, depth, alpha, beta, &ttMove, &value)) { return value; }
+
+  int eval;
+  int best;
+  int bestSquare = NO_SQUARE;
+
+  if (maximizingPlayer) {
+    best = std::numeric_limits<int>::min();
+
+    while (moves) {
+      int square = nextSquare<N>(moves, ttMove);
+      Position child = position;
+      playMove(child, square, LIGHT);
+      eval = minimax(child, depth - 1, alpha, beta, false);
+      if (eval > best) {
+        best = eval;
+        bestSquare = square;
+      }
+      alpha = std::max(alpha, eval);
+      if (beta <= alpha)
+        break;
+    }
+
+  } else {
+    best = std::numeric_limits<int>::max();
+
+    while (moves) {
+      int square = nextSquare<N>(moves, ttMove);
+      Position child = position;
+      playMove(child, square, DARK);
+      eval = minimax(child, depth - 1, alpha, beta, true);
+      if (eval < best) {
+        best = eval;
+        bestSquare = square;
+      }
+      beta = std::min(beta, eval);
+      if (beta <= alpha)
+        break;
+    }
+  }
+
+  if (stopped) { return 0; }
+
+  store(key, symmetry, depth, alphaOrig, betaOrig, best, bestSquare);
+
+  return best;
+}
+
+template<int N>
+Task<int> BasicSearch<N>::minimaxTask(Position position, int depth, int alpha, int beta, bool maximizingPlayer) {
+  if (yieldNodes && ++sinceYield >= yieldNodes) {
+    sinceYield = 0;
+    co_await Yield{&suspended};
+  }
+
+  bool endgame = position.empties() <= ENDGAME_EMPTIES;
+
+  if (timeUp(endgame)) { co_return 0; }
+
+  if (endgame) {
+    int color = maximizingPlayer ? LIGHT : DARK;
+    int lo, hi;
+    discWindow(color, alpha, beta, &lo, &hi);
+
+    int score = co_await solveTask(position, color, lo, hi, cache);
+    co_return (color == LIGHT ? score : -score) * EXACT_SCORE;
+  }
+
+  int maxColor = maximizingPlayer ? DARK : LIGHT;
+
+  if (depth == 0) {
+    co_return evaluateLeaf(position, maxColor, alpha, beta);
+  }
+
+  int color = maximizingPlayer ? LIGHT : DARK;
+  Mask moves = generateMoves(position, color);
+
+  if (!moves) {
+    if (!generateMoves(position, maxColor)) { co_return finalValue(position); }
+    co_return co_await minimaxTask(position, depth, alpha, beta, !maximizingPlayer);
+  }
+
+  int symmetry;
+  uint64_t key = position.key(color, &symmetry);
+  int alphaOrig = alpha;
+  int betaOrig = beta;
+  int ttMove = NO_SQUARE;
+  int value;
+
+  if (probe(key, symmetry, depth, alpha, beta, &ttMove, &value)) { co_return value; }
+
+  int best = maximizingPlayer ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+  int bestSquare = NO_SQUARE;
+
+  while (moves) {
+    int square = nextSquare<N>(moves, ttMove);
+    Position child = position;
+    playMove(child, square, color);
+    int eval = co_await minimaxTask(child, depth - 1, alpha, beta, !maximizingPlayer);
+
+    if (maximizingPlayer ? eval > best : eval < best) {
+      best = eval;
+      bestSquare = square;
+    }
+
+    if (maximizingPlayer) { alpha = std::max(alpha, eval); }
+    else { beta = std::min(beta, eval); }
+
+    if (beta <= alpha)
+      break;
+  }
+
+  if (stopped) { co_return 0; }
+
+  store(key, symmetry, depth, alphaOrig, betaOrig, best, bestSquare);
+
+  co_return best;
+}
+
+template<int N>
+Task<int> BasicSearch<N>::solveTask(Position position, int color, int alpha, int beta, SolvedCache *cache) {
+  if (position.empties() <= TASK_SOLVE_EMPTIES) { co_return BasicEndgame<N>::solve(position, color, alpha, beta, cache); }
+
+  int best;
+  if (BasicEndgame<N>::probeCache(cache, position, color, alpha, beta, &best)) { co_return best; }
+
+  int other = otherColor(color);
+  auto moves = position.legalMoves(color);
+
+  if (BasicEndgame<N>::cutoff(position, color, moves, alpha, beta, &best)) { co_return best; }
+  if (!moves) { co_return -co_await solveTask(position, other, -beta, -alpha); }
+
+  int alphaOrig = alpha;
+  best = -N * N;
+
+  while (moves) {
+    int square = position.firstSquare(moves);
+    moves &= moves - 1;
+
+    Position child = position;
+    child.play(square, color);
+
+    if (yieldNodes) {
+      sinceYield = 0;
+      co_await Yield{&suspended};
+    }
+
+    // The blocking path checks the clock only before a whole solve; here
+    // each resume is a chance to stop instead of finishing it.
+    if (timeUp(true)) { co_return 0; }
+
+    int score = -co_await solveTask(child, other, -beta, -alpha);
+    if (stopped) { co_return 0; }
+
+    if (score > best) {
+      best = score;
+      if (best > alpha) {
+        alpha = best;
+        if (alpha >= beta) { break; }
+      }
+    }
+  }
+
+  BasicEndgame<N>::storeCache(cache, position, color, alphaOrig, beta, best);
+  co_return best;
+}
+
+// Maps a search window onto the disc window of an exact solve for color.
+template<int N>
+void BasicSearch<N>::discWindow(int color, int alpha, int beta, int *lo, int *hi) {
+  *lo = alpha == std::numeric_limits<int>::min() ? -N * N : alpha / EXACT_SCORE - 1;
+  *hi = beta == std::numeric_limits<int>::max() ? N * N : beta / EXACT_SCORE + 1;
+
+  if (color == DARK) {
+    std::swap(*lo, *hi);
+    *lo = -*lo;
+    *hi = -*hi;
+  }
+
+  *lo = std::max(*lo, -N * N);
+  *hi = std::min(*hi, N * N);
+}
+
+template<int N>
+int BasicSearch<N>::finalValue(const Position &position) {
+  return BasicEndgame<N>::finalScore(position, LIGHT) * EXACT_SCORE;
+}
+
+template<int N>
+int BasicSearch<N>::solveEndgame(const Position &position, int alpha, int beta, bool maximizingPlayer) {
+  int color = maximizingPlayer ? LIGHT : DARK;
+  int lo, hi;
+  discWindow(color, alpha, beta, &lo, &hi);
+
+  int score = BasicEndgame<N>::solve(position, color, lo, hi, cache);
+
+  return (color == LIGHT ? score : -score) * EXACT_SCORE;
+}
+
+template<int N>
+int BasicSearch<N>::evaluateLeaf(const Position &position, int color, int alpha, int beta) {
+  if (!fastEval) {
+    fullCount.fetch_add(1, std::memory_order_relaxed);
+    return evaluate(position, color);
+  }
+
+  // The tag keeps scores from other weights apart; the disc count picks
+  // the stage weights.
+  int discs = N * N - position.empties();
+  uint64_t key = position.hash() ^ ((uint64_t) cacheTag << 32 | (uint32_t) (discs * 2 + (color == LIGHT)));
+  int value;
+
+  if (evalCache.probe(key, &value)) {
+    hitCount.fetch_add(1, std::memory_order_relaxed);
+    return value;
+  }
+
+  bool lazy = false;
+  value = evaluate(position, color, alpha, beta, &lazy);
+
+  if (lazy) {
+    lazyCount.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    fullCount.fetch_add(1, std::memory_order_relaxed);
+    evalCache.store(key, value);
+  }
+
+  return value;
+}
+
+template<int N>
+int BasicSearch<N>::evaluate(const Position &position, int color, int alpha, int beta, bool *lazy) {
+  PROFILE_SCOPE(ProfileEvaluate);
+  int other = otherColor(color);
+  int sign = color == DARK ? -1 : 1;
+  int discs = N * N - position.empties();
+
+  int colorScore = Board::getMovesScore(position, color) - Board::getMovesScore(position, other);
+
+  int stabilityScore = Position::bitCount(position.stable(color)) - Position::bitCount(position.stable(other));
+
+  long partial = (long) colorScoreWeight(discs) * colorScore + (long) stabilityScoreWeight(discs) * stabilityScore;
+
+  // Each side has at most one move per empty square.
+  long margin = (long) mobilityScoreWeight(discs) * position.empties();
+  long upper = sign * partial + margin;
+  long lower = sign * partial - margin;
+
+  if (upper <= alpha || lower >= beta) {
+    if (lazy) { *lazy = true; }
+    return (int) (upper <= alpha ? upper : lower);
+  }
+
+  int mobilityScore = Position::bitCount(generateMoves(position, color)) - Position::bitCount(generateMoves(position, other));
+
+  int score = (int) partial + (mobilityScoreWeight(discs) * mobilityScore);
+
+  return sign * score;
+}
+
+// Identifies the evaluation that produced a cached search score: any
+// change to the weights, stage thresholds or board size changes the tag.
+// The top bit keeps it apart from the board-size tags of exact solves.
+template<int N>
+uint32_t BasicSearch<N>::evalTag() {
+  uint32_t hash = 2166136261u;
+  auto add = [&hash](int value) {
+    hash = (hash ^ (uint32_t) value) * 16777619u;
+  };
+
+  add(N);
+  add(Board::earlyStage);
+  add(Board::middleStage);
+  for (int i = 0; i < N * N; i++) {
+    add(Board::earlyVals[i / N][i % N]);
+    add(Board::middleVals[i / N][i % N]);
+    add(Board::lateVals[i / N][i % N]);
+  }
+
+  return hash | 0x80000000u;
+}
+
+template<int N>
+int BasicSearch<N>::colorScoreWeight(int discs) {
+  if (discs == 0) { return 1; }
+  return discs * 100;
+}
+
+template<int N>
+int BasicSearch<N>::stabilityScoreWeight(int discs) {
+  return discs * 1000;
+}
+
+template<int N>
+int BasicSearch<N>::mobilityScoreWeight(int discs) {
+  if (discs == 0) { return 1; }
+  return 10000 / discs;
+}
+
+template class BasicSearch<6>;
+template class BasicSearch<8>;
+template class BasicSearch<10>;
@@ -0,0 +1,167 @@
+#include "SearchScheduler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+#include "Bench.h"
+
+static bool later(const std::unique_ptr<SearchJob> &a, const std::unique_ptr<SearchJob> &b) {
+  return a->pass > b->pass;
+}
+
+SearchJob::SearchJob(TranspositionTable *table, Book *book, const Options &options)
+    : search(table, book, options), priority(1), pass(0) {}
+
+SearchScheduler::SearchScheduler(TranspositionTable *table, Book *book, const Options &options)
+    : table(table), book(book), options(options) {
+  this->options.threads = 1;
+}
+
+void SearchScheduler::submit(const Board &board, int color, int priority, std::function<void(Move, const Search &)> done) {
+  auto job = std::make_unique<SearchJob>(table, book, options);
+  job->search.yieldNodes = YIELD_NODES;
+  job->task = job->search.bestMoveTask(board, color);
+  job->next = job->task.handle;
+  job->done = std::move(done);
+  job->priority = std::max(1, priority);
+  job->pass = pass;
+
+  jobs.push_back(std::move(job));
+  std::push_heap(jobs.begin(), jobs.end(), later);
+}
+
+bool SearchScheduler::step() {
+  if (jobs.empty()) { return false; }
+
+  std::pop_heap(jobs.begin(), jobs.end(), later);
+  SearchJob &job = *jobs.back();
+  pass = job.pass;
+
+  auto start = std::chrono::steady_clock::now();
+  int64_t used;
+
+  do {
+    std::exchange(job.next, {}).resume();
+    used = Bench::microsSince(start);
+
+    if (job.task.done()) {
+      std::unique_ptr<SearchJob> finished = std::move(jobs.back());
+      jobs.pop_back();
+      finished->done(finished->task.result(), finished->search);
+      return true;
+    }
+
+    job.next = std::exchange(job.search.suspended, {});
+  } while (used < SLICE_US);
+
+  job.pass += (double) used / job.priority;
+  std::push_heap(jobs.begin(), jobs.end(), later);
+  return true;
+}
+
+void SearchScheduler::run() {
+  while (step()) {}
+}
+
+size_t SearchScheduler::size() const {
+  return jobs.size();
+}
+
+static void report(const char *mode, double seconds, std::vector<int64_t> &latencies, const std::vector<int> &depths) {
+  int64_t p50, p99;
+  Bench::percentiles(latencies, &p50, &p99);
+
+  double depth = 0;
+  for (int d : depths)
+    depth += d;
+
+  printf("%-18s %9.2f %12.1f %10.2f %10.2f %8.2f\n", mode, seconds, (double) latencies.size() / seconds,
+         (double) p50 / 1000.0, (double) p99 / 1000.0, depth / (double) depths.size());
+}
+
+int SearchScheduler::bench(const Options &options, int searches) {
+  std::vector<BenchPosition> positions = Bench::positions(searches);
+  Options searchOptions = Bench::searchOptions(options);
+  TranspositionTable table(options.hashSize);
+
+  std::vector<std::chrono::steady_clock::time_point> arrivals((size_t) searches);
+  std::vector<int64_t> latencies((size_t) searches);
+  std::vector<int> depths((size_t) searches);
+
+  auto search = [&](size_t i) {
+    Board board(positions[i].position);
+    Search search(&table, nullptr, searchOptions);
+    search.bestMove(&board, positions[i].color);
+    depths[i] = search.depthReached;
+  };
+
+  auto finish = [&](size_t i) {
+    latencies[i] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - arrivals[i]).count();
+  };
+
+  // Paced arrivals keep the box at BENCH_LOAD of its serial capacity; a
+  // burst submits every search at once.
+  auto start = std::chrono::steady_clock::now();
+  size_t sample = std::min((size_t) searches, (size_t) 100);
+  for (size_t i = 0; i < sample; i++)
+    search(i);
+  auto paced = std::chrono::microseconds((int64_t) ((double) Bench::microsSince(start) / (double) sample / BENCH_LOAD));
+
+  printf("%d searches, depth %d, time %d ms\n", searches, options.depth, options.timePerMove);
+
+  for (auto interval : {paced, std::chrono::microseconds(0)}) {
+    auto begin = [&]() {
+      table.clear();
+      start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < arrivals.size(); i++)
+        arrivals[i] = start + interval * (int64_t) i;
+    };
+
+    if (interval.count())
+      printf("\npaced, one every %.2f ms\n", (double) interval.count() / 1000.0);
+    else
+      printf("\nburst\n");
+    printf("%-18s %9s %12s %10s %10s %8s\n", "mode", "wall s", "searches/s", "p50 ms", "p99 ms", "depth");
+
+    begin();
+    for (size_t i = 0; i < arrivals.size(); i++) {
+      std::this_thread::sleep_until(arrivals[i]);
+      search(i);
+      finish(i);
+    }
+    report("serial", (double) Bench::microsSince(start) / 1e6, latencies, depths);
+
+    begin();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < arrivals.size(); i++) {
+      std::this_thread::sleep_until(arrivals[i]);
+      threads.emplace_back([&, i]() {
+        search(i);
+        finish(i);
+      });
+    }
+    for (auto &thread : threads)
+      thread.join();
+    report("thread-per-search", (double) Bench::microsSince(start) / 1e6, latencies, depths);
+
+    begin();
+    SearchScheduler scheduler(&table, nullptr, searchOptions);
+    size_t submitted = 0;
+    while (submitted < arrivals.size() || scheduler.size()) {
+      while (submitted < arrivals.size() && arrivals[submitted] <= std::chrono::steady_clock::now()) {
+        size_t i = submitted++;
+        scheduler.submit(Board(positions[i].position), positions[i].color, 1, [&, i](Move, const Search &search) {
+          depths[i] = search.depthReached;
+          finish(i);
+        });
+      }
+
+      if (!scheduler.step() && submitted < arrivals.size())
+        std::this_thread::sleep_until(arrivals[submitted]);
+    }
+    report("coroutines", (double) Bench::microsSince(start) / 1e6, latencies, depths);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,738 @@
+#include "Server.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include "Bench.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static bool sendAll(int fd, const std::string &data) {
+  size_t sent = 0;
+
+  while (sent < data.size()) {
+    ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n <= 0) { return false; }
+    sent += (size_t) n;
+  }
+
+  return true;
+}
+
+Server::Server(const Options &options, Book *book)
+    : options(options), table(options.hashSize), book(book), pool(options.threads) {
+  if (!options.cachePath.empty())
+    cache = std::make_unique<SolvedCache>(options.cachePath);
+}
+
+Server::~Server() {
+  // Searches still running post() to the wake pipe and read the table,
+  // so they have to finish before anything is closed.
+  pool.shutdown();
+
+  for (auto &client : clients)
+    close(client.first);
+
+  if (listenFd >= 0) { close(listenFd); }
+  if (wakeFds[0] >= 0) { close(wakeFds[0]); }
+  if (wakeFds[1] >= 0) { close(wakeFds[1]); }
+  if (!socketPath.empty()) { unlink(socketPath.c_str()); }
+}
+
+bool Server::listen(const std::string &address) {
+  if (pipe(wakeFds) != 0) {
+    printf("Unable to create wake pipe: %s\n", strerror(errno));
+    return false;
+  }
+
+  fcntl(wakeFds[0], F_SETFL, O_NONBLOCK);
+  fcntl(wakeFds[1], F_SETFL, O_NONBLOCK);
+
+  auto colon = address.rfind(':');
+
+  if (address[0] != '/' && colon != std::string::npos) {
+    std::string port = address.substr(colon + 1);
+    char *end;
+    errno = 0;
+    long number = strtol(port.c_str(), &end, 10);
+
+    if (port.empty() || *end || errno || number < 1 || number > 65535) {
+      printf("Invalid port %s\n", port.c_str());
+      return false;
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t) number);
+
+    if (inet_pton(AF_INET, address.substr(0, colon).c_str(), &addr.sin_addr) != 1) {
+      printf("Invalid address %s\n", address.c_str());
+      return false;
+    }
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    int yes = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    if (bind(listenFd, (sockaddr *) &addr, sizeof(addr)) != 0) {
+      printf("Unable to bind %s: %s\n", address.c_str(), strerror(errno));
+      return false;
+    }
+  } else {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+
+    if (address.size() >= sizeof(addr.sun_path)) {
+      printf("Socket path too long: %s\n", address.c_str());
+      return false;
+    }
+
+    strcpy(addr.sun_path, address.c_str());
+    unlink(address.c_str());
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (bind(listenFd, (sockaddr *) &addr, sizeof(addr)) != 0) {
+      printf("Unable to bind %s: %s\n", address.c_str(), strerror(errno));
+      return false;
+    }
+
+    socketPath = address;
+  }
+
+  if (::listen(listenFd, SERVER_BACKLOG) != 0) {
+    printf("Unable to listen on %s: %s\n", address.c_str(), strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+void Server::run() {
+  running = true;
+  std::vector<pollfd> fds;
+
+  while (running) {
+    fds.clear();
+    fds.push_back(pollfd{wakeFds[0], POLLIN, 0});
+    fds.push_back(pollfd{listenFd, POLLIN, 0});
+    for (auto &client : clients) {
+      short events = client.second.output.size() < SERVER_OUTPUT ? POLLIN : 0;
+      if (!client.second.output.empty()) { events |= POLLOUT; }
+      fds.push_back(pollfd{client.first, events, 0});
+    }
+
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) { continue; }
+      printf("poll failed: %s\n", strerror(errno));
+      break;
+    }
+
+    if (fds[0].revents) {
+      char drain[64];
+      while (read(wakeFds[0], drain, sizeof(drain)) > 0) {}
+      finishCompletions();
+    }
+
+    if (fds[1].revents & POLLIN)
+      acceptClient();
+
+    for (size_t i = 2; i < fds.size(); i++) {
+      int fd = fds[i].fd;
+      bool open = true;
+
+      if (fds[i].revents & POLLOUT)
+        open = writeClient(fd);
+      if (open && (fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+        open = readClient(fd);
+      if (!open)
+        closeClient(fd);
+    }
+  }
+}
+
+void Server::stop() {
+  running = false;
+  if (write(wakeFds[1], "s", 1) < 0) {}
+}
+
+std::string Server::stats() {
+  std::vector<int64_t> copy;
+  uint64_t count;
+  {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    copy = latencies;
+    count = latencyCount;
+  }
+
+  int64_t p50, p99;
+  Bench::percentiles(copy, &p50, &p99);
+
+  std::ostringstream out;
+  out << "stats " << count << " " << p50 << " " << p99;
+  return out.str();
+}
+
+std::string Server::squareName(int col, int row) {
+  return std::string(1, (char) ('a' + col)) + std::to_string(row + 1);
+}
+
+bool Server::parseSquare(const std::string &name, int *col, int *row) {
+  if (name.size() < 2 || name[0] < 'a' || name[0] >= 'a' + SIZE) { return false; }
+
+  *col = name[0] - 'a';
+  *row = atoi(name.c_str() + 1) - 1;
+  return *row >= 0 && *row < SIZE;
+}
+
+void Server::acceptClient() {
+  int fd = accept(listenFd, nullptr, nullptr);
+  if (fd < 0) { return; }
+
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  clients[fd] = Client{};
+}
+
+bool Server::readClient(int fd) {
+  char buf[SERVER_READ];
+  ssize_t n = recv(fd, buf, sizeof(buf), 0);
+  if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) { return true; }
+  if (n <= 0) { return false; }
+
+  std::string &pending = clients[fd].input;
+  pending.append(buf, (size_t) n);
+
+  size_t start = 0;
+  size_t end;
+  while ((end = pending.find('\n', start)) != std::string::npos) {
+    std::string line = pending.substr(start, end - start);
+    if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+    handleLine(fd, line);
+    start = end + 1;
+  }
+
+  pending.erase(0, start);
+  return pending.size() <= SERVER_LINE;
+}
+
+bool Server::writeClient(int fd) {
+  std::string &output = clients[fd].output;
+  size_t sent = 0;
+
+  while (sent < output.size()) {
+    ssize_t n = send(fd, output.data() + sent, output.size() - sent, MSG_NOSIGNAL);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) { break; }
+    if (n <= 0) { return false; }
+    sent += (size_t) n;
+  }
+
+  output.erase(0, sent);
+  return true;
+}
+
+void Server::closeClient(int fd) {
+  for (auto &job : clients[fd].jobs)
+    sessions[job.session].busy = 0;
+
+  ready.erase(std::remove(ready.begin(), ready.end(), fd), ready.end());
+  close(fd);
+  clients.erase(fd);
+
+  for (uint32_t id = 0; id < sessions.size(); id++) {
+    Session &session = sessions[id];
+    if (!session.active || session.client != fd) { continue; }
+
+    session.active = 0;
+    if (!session.busy)
+      freeSessions.push_back(id);
+  }
+}
+
+void Server::reply(int fd, const std::string &line) {
+  auto client = clients.find(fd);
+  if (client == clients.end()) { return; }
+
+  client->second.output += line;
+  client->second.output += '\n';
+
+  // Errors surface through poll() as POLLHUP/POLLERR.
+  writeClient(fd);
+}
+
+static bool gameOver(const Position &position) {
+  return !position.legalMoves(DARK) && !position.legalMoves(LIGHT);
+}
+
+static std::string gameOverLine(uint32_t id, const Position &position) {
+  std::ostringstream out;
+  out << id << " gameover " << position.count(DARK) << " " << position.count(LIGHT);
+  return out.str();
+}
+
+bool Server::play(Session &session, int col, int row) {
+  int square = Position::square(col, row);
+  if (!(session.position.legalMoves(session.turn) & Position::bit(square))) { return false; }
+
+  session.position.play(square, session.turn);
+  session.turn = (int8_t) (session.turn == DARK ? LIGHT : DARK);
+
+  if (!session.position.legalMoves(session.turn))
+    session.turn = (int8_t) (session.turn == DARK ? LIGHT : DARK);
+
+  return true;
+}
+
+void Server::handleLine(int fd, const std::string &line) {
+  std::istringstream in(line);
+  std::string first;
+  if (!(in >> first)) { return; }
+
+  if (first == "new") {
+    uint32_t id;
+    if (!freeSessions.empty()) {
+      id = freeSessions.back();
+      freeSessions.pop_back();
+    } else {
+      id = (uint32_t) sessions.size();
+      sessions.emplace_back();
+    }
+
+    sessions[id] = Session{Position::initial(), fd, DARK, 1, 0};
+    reply(fd, std::to_string(id) + " ok");
+    return;
+  }
+
+  if (first == "setoption") {
+    std::string name, value;
+    in >> name >> value;
+
+    // Paths are only taken from reversi.cfg or the command line: a client
+    // must not be able to point the server at a file to read or write. The
+    // pool is sized at startup and every search runs on one worker.
+    if (name == "threads" || name == "cache" || name == "weights") {
+      reply(fd, "error option");
+      return;
+    }
+
+    // Workers hold on to the table for the whole search.
+    bool busy = std::any_of(sessions.begin(), sessions.end(), [](const Session &s) { return s.busy; });
+    if (name == "hash" && busy) {
+      reply(fd, "error busy");
+      return;
+    }
+
+    if (!options.set(name, value)) {
+      reply(fd, "error option");
+      return;
+    }
+
+    if (name == "hash")
+      table.resize((size_t) options.hashSize);
+
+    reply(fd, "ok");
+    return;
+  }
+
+  if (first == "stats") {
+    reply(fd, stats());
+    return;
+  }
+
+  char *endPtr;
+  unsigned long id = strtoul(first.c_str(), &endPtr, 10);
+  std::string command;
+  in >> command;
+
+  if (*endPtr || id >= sessions.size() || !sessions[id].active || sessions[id].client != fd) {
+    reply(fd, first + " error session");
+    return;
+  }
+
+  Session &session = sessions[id];
+  std::string prefix = std::to_string(id) + " ";
+
+  if (session.busy && command != "close") {
+    reply(fd, prefix + "error busy");
+    return;
+  }
+
+  if (command == "move") {
+    std::string name;
+    int col, row;
+    in >> name;
+
+    if (!parseSquare(name, &col, &row) || !play(session, col, row)) {
+      reply(fd, prefix + "error illegal");
+      return;
+    }
+
+    reply(fd, prefix + "ok");
+    if (gameOver(session.position))
+      reply(fd, gameOverLine((uint32_t) id, session.position));
+
+  } else if (command == "go") {
+    int ms;
+    int budget = (in >> ms) ? ms : options.timePerMove;
+
+    if (gameOver(session.position)) {
+      reply(fd, gameOverLine((uint32_t) id, session.position));
+      return;
+    }
+
+    schedule(fd, (uint32_t) id, budget, 0);
+
+  } else if (command == "analyze") {
+    int lines = 1;
+    int ms;
+    in >> lines;
+    int budget = (in >> ms) ? ms : options.timePerMove;
+
+    if (lines < 1 || !session.position.legalMoves(session.turn)) {
+      reply(fd, prefix + "error analyze");
+      return;
+    }
+
+    schedule(fd, (uint32_t) id, budget, lines);
+
+  } else if (command == "board") {
+    std::string cells;
+    for (int row = 0; row < SIZE; row++)
+      for (int col = 0; col < SIZE; col++) {
+        int color = session.position.getColor(col, row);
+        cells += color == DARK ? 'x' : color == LIGHT ? 'o' : '.';
+      }
+
+    reply(fd, prefix + "board " + cells + (session.turn == DARK ? " x" : " o"));
+
+  } else if (command == "close") {
+    session.active = 0;
+    if (!session.busy)
+      freeSessions.push_back((uint32_t) id);
+    reply(fd, prefix + "ok");
+
+  } else {
+    reply(fd, prefix + "error command");
+  }
+}
+
+void Server::schedule(int fd, uint32_t id, int budget, int lines) {
+  sessions[id].busy = 1;
+
+  Client &client = clients[fd];
+  if (client.jobs.empty())
+    ready.push_back(fd);
+  client.jobs.push_back(Job{id, budget, lines, std::chrono::steady_clock::now()});
+
+  dispatch();
+}
+
+void Server::dispatch() {
+  while (searching < pool.size() && !ready.empty()) {
+    int fd = ready.front();
+    ready.pop_front();
+
+    Client &client = clients[fd];
+    Job job = client.jobs.front();
+    client.jobs.pop_front();
+    if (!client.jobs.empty())
+      ready.push_back(fd);
+
+    // Closed while it waited.
+    Session &session = sessions[job.session];
+    if (!session.active) {
+      session.busy = 0;
+      freeSessions.push_back(job.session);
+      continue;
+    }
+
+    searching++;
+    start(fd, job);
+  }
+}
+
+void Server::start(int fd, const Job &job) {
+  Session &session = sessions[job.session];
+  Position position = session.position;
+  int color = session.turn;
+  Options searchOptions = options;
+  searchOptions.threads = 1;
+
+  uint32_t id = job.session;
+  int budget = job.budget;
+  int lines = job.lines;
+  auto arrival = job.arrival;
+  auto deadline = arrival + std::chrono::milliseconds(budget);
+
+  pool.submit([this, fd, id, position, color, budget, lines, searchOptions, arrival, deadline]() mutable {
+    if (budget > 0) {
+      auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+      searchOptions.timePerMove = std::max(1, (int) left.count());
+    }
+
+    Board board(position);
+    Search search(&table, book, searchOptions, cache.get());
+
+    if (!lines) {
+      Move move = search.bestMove(&board, color);
+      if (cache) { cache->flush(); }
+      post(Completion{fd, id, CompletionMove, move, Bench::microsSince(arrival), ""});
+      return;
+    }
+
+    std::string prefix = std::to_string(id) + " ";
+    auto stream = [&](int depth, const std::vector<PVLine> &ranked) {
+      for (size_t rank = 0; rank < ranked.size(); rank++) {
+        std::ostringstream out;
+        out << prefix << "pv " << depth << " " << rank + 1 << " " << ranked[rank].score;
+        for (auto &move : ranked[rank].pv)
+          out << " " << squareName(move.col, move.row);
+        post(Completion{fd, id, CompletionInfo, Move(-1, -1), 0, out.str()});
+      }
+    };
+
+    search.analyze(&board, color, lines, stream);
+    if (cache) { cache->flush(); }
+    post(Completion{fd, id, CompletionAnalysis, Move(-1, -1), Bench::microsSince(arrival),
+                    prefix + "analysis done " + std::to_string(search.depthReached)});
+  });
+}
+
+void Server::post(const Completion &completion) {
+  {
+    std::lock_guard<std::mutex> lock(completionMutex);
+    completions.push_back(completion);
+  }
+
+  if (write(wakeFds[1], "c", 1) < 0) {}
+}
+
+void Server::finishCompletions() {
+  std::vector<Completion> done;
+  {
+    std::lock_guard<std::mutex> lock(completionMutex);
+    done.swap(completions);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    for (auto &c : done) {
+      if (c.kind != CompletionMove) { continue; }
+
+      if (latencies.size() < SERVER_LATENCIES) {
+        latencies.push_back(c.latency);
+      } else {
+        latencies[latencyCount % SERVER_LATENCIES] = c.latency;
+      }
+      latencyCount++;
+    }
+  }
+
+  for (auto &c : done) {
+    Session &session = sessions[c.session];
+
+    if (c.kind == CompletionInfo) {
+      if (session.active)
+        reply(c.client, c.text);
+      continue;
+    }
+
+    searching--;
+    session.busy = 0;
+
+    if (!session.active) {
+      freeSessions.push_back(c.session);
+      continue;
+    }
+
+    if (c.kind == CompletionAnalysis) {
+      reply(c.client, c.text);
+      continue;
+    }
+
+    std::string prefix = std::to_string(c.session) + " ";
+
+    if (c.move.col < 0 || !play(session, c.move.col, c.move.row)) {
+      reply(c.client, prefix + "bestmove pass");
+      continue;
+    }
+
+    reply(c.client, prefix + "bestmove " + squareName(c.move.col, c.move.row));
+    if (gameOver(session.position))
+      reply(c.client, gameOverLine(c.session, session.position));
+  }
+
+  dispatch();
+}
+
+struct BenchGame {
+  uint32_t id;
+  Position position;
+  int turn;
+  int pending;
+  std::chrono::steady_clock::time_point sent;
+};
+
+static void benchClient(const std::string &path, int count, unsigned seed, std::vector<int64_t> *latencies) {
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path.c_str());
+
+  if (connect(fd, (sockaddr *) &addr, sizeof(addr)) != 0) {
+    printf("Unable to connect to %s: %s\n", path.c_str(), strerror(errno));
+    close(fd);
+    return;
+  }
+
+  std::mt19937 rng(seed);
+  std::vector<BenchGame> games;
+  std::unordered_map<uint32_t, size_t> index;
+  std::string pending;
+  int active = count;
+
+  auto act = [&](BenchGame &game) {
+    std::string line = std::to_string(game.id);
+
+    if (game.turn == DARK) {
+      auto moves = game.position.legalMoves(DARK);
+      for (int k = (int) (rng() % (unsigned) Position::bitCount(moves)); k > 0; k--)
+        moves &= moves - 1;
+      game.pending = Position::firstSquare(moves);
+      line += " move " + Server::squareName(game.pending % SIZE, game.pending / SIZE);
+    } else {
+      game.pending = -1;
+      line += " go";
+    }
+
+    game.sent = std::chrono::steady_clock::now();
+    sendAll(fd, line + "\n");
+  };
+
+  auto advance = [&](BenchGame &game, int square) {
+    game.position.play(square, game.turn);
+    game.turn = game.turn == DARK ? LIGHT : DARK;
+
+    if (!game.position.legalMoves(game.turn))
+      game.turn = game.turn == DARK ? LIGHT : DARK;
+
+    if (gameOver(game.position)) {
+      active--;
+      return;
+    }
+
+    act(game);
+  };
+
+  std::string requests;
+  for (int i = 0; i < count; i++)
+    requests += "new\n";
+  sendAll(fd, requests);
+
+  char buf[SERVER_READ];
+
+  while (active > 0) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) { break; }
+    pending.append(buf, (size_t) n);
+
+    size_t start = 0;
+    size_t end;
+    while ((end = pending.find('\n', start)) != std::string::npos) {
+      std::istringstream in(pending.substr(start, end - start));
+      start = end + 1;
+
+      uint32_t id;
+      std::string word, arg;
+      in >> id >> word >> arg;
+
+      auto found = index.find(id);
+
+      if (found == index.end()) {
+        if (word != "ok") { continue; }
+        index[id] = games.size();
+        games.push_back(BenchGame{id, Position::initial(), DARK, -1, {}});
+        act(games.back());
+        continue;
+      }
+
+      BenchGame &game = games[found->second];
+
+      if (word == "ok" && game.pending >= 0) {
+        advance(game, game.pending);
+      } else if (word == "bestmove") {
+        latencies->push_back(Bench::microsSince(game.sent));
+        int col, row;
+        if (Server::parseSquare(arg, &col, &row)) {
+          advance(game, Position::square(col, row));
+        } else {
+          active--;
+        }
+      } else if (word == "error") {
+        printf("session %u: %s\n", id, arg.c_str());
+        active--;
+      }
+    }
+
+    pending.erase(0, start);
+  }
+
+  close(fd);
+}
+
+int Server::bench(const Options &options, int sessions) {
+  std::string path = "/tmp/reversi-bench-" + std::to_string(getpid()) + ".sock";
+  Book book;
+  if (options.useBook) { book.load(options.dataPath(BOOK).c_str()); }
+
+  // Results left on disk by earlier runs would skew every later one.
+  Options serverOptions = options;
+  serverOptions.cachePath = "";
+
+  Server server(serverOptions, &book);
+  if (!server.listen(path)) { return EXIT_FAILURE; }
+
+  std::thread loop([&server]() { server.run(); });
+
+  int connections = std::min(BENCH_CONNECTIONS, sessions);
+  std::vector<std::vector<int64_t>> results((size_t) connections);
+  std::vector<std::thread> clients;
+  auto start = std::chrono::steady_clock::now();
+
+  for (int i = 0; i < connections; i++) {
+    int count = sessions / connections + (i < sessions % connections ? 1 : 0);
+    clients.emplace_back(benchClient, path, count, (unsigned) i + 1, &results[(size_t) i]);
+  }
+
+  for (auto &client : clients)
+    client.join();
+
+  double seconds = (double) Bench::microsSince(start) / 1e6;
+  std::vector<int64_t> all;
+  for (auto &r : results)
+    all.insert(all.end(), r.begin(), r.end());
+
+  int64_t p50, p99;
+  Bench::percentiles(all, &p50, &p99);
+
+  printf("sessions:     %d\n", sessions);
+  printf("workers:      %d\n", options.threads);
+  printf("ai moves:     %zu\n", all.size());
+  printf("wall time:    %.2f s\n", seconds);
+  printf("throughput:   %.1f moves/s\n", (double) all.size() / seconds);
+  printf("latency p50:  %.2f ms\n", (double) p50 / 1000.0);
+  printf("latency p99:  %.2f ms\n", (double) p99 / 1000.0);
+  printf("server %s\n", server.stats().c_str());
+
+  server.stop();
+  loop.join();
+  return EXIT_SUCCESS;
+}
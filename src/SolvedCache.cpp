@@ -0,0 +1,254 @@
+#include "SolvedCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint64_t mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+static uint32_t checksum(const CacheRecord &record) {
+  return (uint32_t) mix(record.key ^ mix(record.data ^ ((uint64_t) record.tag << 32 | CACHE_MAGIC)));
+}
+
+static uint64_t indexKey(uint64_t key, uint32_t tag) {
+  return key ^ mix(tag + 1);
+}
+
+static int64_t nowMillis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+SolvedCache::SolvedCache(const std::string &path) : filePath(path) {}
+
+SolvedCache::~SolvedCache() {
+  flush();
+
+#ifndef _WIN32
+  if (fd >= 0) { close(fd); }
+#endif
+}
+
+const std::string &SolvedCache::path() const {
+  return filePath;
+}
+
+bool SolvedCache::open() {
+  std::call_once(opened, [this]() {
+#ifndef _WIN32
+    if (filePath.empty()) { return; }
+
+    fd = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+      printf("Unable to open cache %s: %s\n", filePath.c_str(), strerror(errno));
+      return;
+    }
+
+    refresh();
+#endif
+  });
+
+  return fd >= 0;
+}
+
+void SolvedCache::refresh() {
+  std::unique_lock<std::mutex> lock(refreshMutex, std::try_to_lock);
+  if (!lock.owns_lock()) { return; }
+
+  scan();
+}
+
+bool SolvedCache::scan() {
+#ifndef _WIN32
+  nextRefresh = nowMillis() + CACHE_REFRESH_MS;
+
+  // pread() rather than mmap(): another process may cut the file back
+  // while we read, and a short read is just the end of the file where a
+  // mapped page past it would be SIGBUS.
+  struct stat st{};
+  if (fstat(fd, &st) != 0) { return false; }
+  if ((size_t) st.st_size < sizeof(CacheHeader)) { return true; }
+
+  size_t length = (size_t) st.st_size;
+  if (length <= scanned && scanned) { return true; }
+
+  if (!scanned) {
+    CacheHeader header;
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t) sizeof(header)) { return false; }
+
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.recordSize != sizeof(CacheRecord)) {
+      if (!foreign) { printf("Ignoring cache %s: unknown format\n", filePath.c_str()); }
+      foreign = true;
+      return false;
+    }
+
+    scanned = sizeof(CacheHeader);
+  }
+
+  std::vector<CacheRecord> records;
+  std::vector<CacheRecord> chunk(CACHE_READ);
+  bool good = true;
+
+  while (good && scanned + sizeof(CacheRecord) <= length) {
+    size_t want = std::min(chunk.size(), (length - scanned) / sizeof(CacheRecord));
+    ssize_t n = pread(fd, chunk.data(), want * sizeof(CacheRecord), (off_t) scanned);
+    if (n < 0) { return false; }
+    if (n < (ssize_t) sizeof(CacheRecord)) { break; }
+
+    for (size_t i = 0; i < (size_t) n / sizeof(CacheRecord); i++) {
+      if (chunk[i].check != checksum(chunk[i])) {
+        good = false;
+        break;
+      }
+
+      records.push_back(chunk[i]);
+      scanned += sizeof(CacheRecord);
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> write(indexMutex);
+  for (auto &record : records)
+    insert(record);
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool SolvedCache::insert(const CacheRecord &record) {
+  auto found = index.find(indexKey(record.key, record.tag));
+
+  if (found != index.end()) {
+    TTEntry old = TranspositionTable::unpack(found->second);
+    TTEntry entry = TranspositionTable::unpack(record.data);
+
+    if (old.depth > entry.depth) { return false; }
+
+    // At equal depth only an exact score or a tighter bound of the same
+    // kind replaces an entry, so repeated runs converge instead of
+    // appending the same positions again.
+    if (old.depth == entry.depth && entry.flag != TT_EXACT) {
+      if (old.flag != entry.flag) { return false; }
+      if (entry.flag == TT_LOWER && entry.value <= old.value) { return false; }
+      if (entry.flag == TT_UPPER && entry.value >= old.value) { return false; }
+    }
+
+    if (old.depth == entry.depth && old.flag == TT_EXACT) { return false; }
+  }
+
+  index[indexKey(record.key, record.tag)] = record.data;
+  return true;
+}
+
+bool SolvedCache::probe(uint64_t key, uint32_t tag, TTEntry *entry) {
+  if (!open()) { return false; }
+
+  {
+    std::shared_lock<std::shared_mutex> read(indexMutex);
+    auto found = index.find(indexKey(key, tag));
+    if (found != index.end()) {
+      *entry = TranspositionTable::unpack(found->second);
+      return true;
+    }
+  }
+
+  if (nowMillis() >= nextRefresh)
+    refresh();
+
+  return false;
+}
+
+void SolvedCache::store(uint64_t key, uint32_t tag, int value, int depth, int flag, int move) {
+  if (!open()) { return; }
+
+  CacheRecord record{key, TranspositionTable::pack(value, depth, flag, move), tag, 0};
+  record.check = checksum(record);
+
+  {
+    std::unique_lock<std::shared_mutex> write(indexMutex);
+    if (!insert(record)) { return; }
+  }
+
+  bool full;
+  {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    int64_t now = nowMillis();
+    if (pending.empty()) { pendingSince = now; }
+    pending.push_back(record);
+    full = pending.size() >= CACHE_BATCH || now - pendingSince >= CACHE_FLUSH_MS;
+  }
+
+  if (full)
+    flush();
+}
+
+void SolvedCache::flush() {
+#ifndef _WIN32
+  std::vector<CacheRecord> batch;
+  {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    batch.swap(pending);
+  }
+
+  if (batch.empty() || fd < 0) { return; }
+
+  flock(fd, LOCK_EX);
+  std::lock_guard<std::mutex> lock(refreshMutex);
+
+  // Catch up with the other writers first: scan() stops at the first
+  // record that fails its check, and everything from there on is cut off
+  // so the batch lands where readers will find it. If the scan itself
+  // failed, scanned may be short of other writers' records, so nothing is
+  // cut or written and the batch waits for the next flush.
+  struct stat st{};
+  if (!scan() || fstat(fd, &st) != 0) {
+    if (!foreign) {
+      std::lock_guard<std::mutex> lock(writeMutex);
+      pending.insert(pending.begin(), batch.begin(), batch.end());
+    }
+  } else {
+    size_t length = (size_t) st.st_size;
+
+    if (length < sizeof(CacheHeader)) {
+      CacheHeader header{CACHE_MAGIC, CACHE_VERSION, sizeof(CacheRecord), 0};
+      if (ftruncate(fd, 0) != 0 || write(fd, &header, sizeof(header)) != (ssize_t) sizeof(header))
+        printf("Unable to write cache %s: %s\n", filePath.c_str(), strerror(errno));
+      scanned = sizeof(CacheHeader);
+    } else if (length > scanned) {
+      if (ftruncate(fd, (off_t) scanned) != 0)
+        printf("Unable to repair cache %s: %s\n", filePath.c_str(), strerror(errno));
+    }
+
+    size_t bytes = batch.size() * sizeof(CacheRecord);
+    if (write(fd, batch.data(), bytes) == (ssize_t) bytes && fdatasync(fd) == 0) {
+      scanned += bytes;
+    } else {
+      printf("Unable to write cache %s: %s\n", filePath.c_str(), strerror(errno));
+    }
+  }
+
+  flock(fd, LOCK_UN);
+#endif
+}
+
+size_t SolvedCache::size() {
+  open();
+  std::shared_lock<std::shared_mutex> read(indexMutex);
+  return index.size();
+}
@@ -0,0 +1,81 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threads) {
+  threads = std::max(1, threads);
+
+  for (int i = 0; i < threads; i++)
+    queues.emplace_back(new Queue());
+
+  for (int i = 0; i < threads; i++)
+    workers.emplace_back(&ThreadPool::run, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+  shutdown();
+}
+
+void ThreadPool::shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = true;
+  }
+  wake.notify_all();
+
+  for (auto &worker : workers)
+    if (worker.joinable())
+      worker.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  Queue &queue = *queues[next++ % queues.size()];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    pending++;
+  }
+  wake.notify_one();
+}
+
+int ThreadPool::size() const {
+  return (int) workers.size();
+}
+
+bool ThreadPool::take(int index, std::function<void()> &task) {
+  int count = (int) queues.size();
+
+  for (int i = 0; i < count; i++) {
+    Queue &queue = *queues[(index + i) % count];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      pending--;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ThreadPool::run(int index) {
+  std::function<void()> task;
+
+  for (;;) {
+    if (take(index, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    wake.wait(lock, [this] { return stopping || pending > 0; });
+    if (stopping && pending == 0) { return; }
+  }
+}
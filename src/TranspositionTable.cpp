@@ -0,0 +1,65 @@
+#include "TranspositionTable.h"
+
+uint64_t TranspositionTable::pack(int value, int depth, int flag, int move) {
+  return (uint64_t) (uint32_t) value |
+         (uint64_t) (uint8_t) depth << 32 |
+         (uint64_t) (uint8_t) flag << 40 |
+         (uint64_t) (uint8_t) move << 48;
+}
+
+TTEntry TranspositionTable::unpack(uint64_t data) {
+  TTEntry entry{};
+  entry.value = (int32_t) (uint32_t) data;
+  entry.depth = (int8_t) (data >> 32);
+  entry.flag = (uint8_t) (data >> 40);
+  entry.move = (uint8_t) (data >> 48);
+  return entry;
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes) {
+  resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+  size_t n = 1;
+  while (n * 2 * sizeof(TTSlot) <= megabytes * 1024 * 1024)
+    n *= 2;
+
+  slots.reset(new TTSlot[n]);
+  count = n;
+  mask = n - 1;
+  size = megabytes;
+}
+
+size_t TranspositionTable::megabytes() const {
+  return size;
+}
+
+void TranspositionTable::clear() {
+  for (size_t i = 0; i < count; i++) {
+    slots[i].check.store(0, std::memory_order_relaxed);
+    slots[i].data.store(0, std::memory_order_relaxed);
+  }
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry *entry) const {
+  const TTSlot &slot = slots[key & mask];
+  uint64_t data = slot.data.load(std::memory_order_relaxed);
+  uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+  if ((check ^ data) != key || data == 0) { return false; }
+
+  *entry = unpack(data);
+  return true;
+}
+
+void TranspositionTable::store(uint64_t key, int value, int depth, int flag, int move) {
+  TTSlot &slot = slots[key & mask];
+  uint64_t old = slot.data.load(std::memory_order_relaxed);
+
+  if ((slot.check.load(std::memory_order_relaxed) ^ old) == key && unpack(old).depth > depth) { return; }
+
+  uint64_t data = pack(value, depth, flag, move);
+  slot.check.store(key ^ data, std::memory_order_relaxed);
+  slot.data.store(data, std::memory_order_relaxed);
+}
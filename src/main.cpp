@@ -1,7 +1,112 @@
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
 #include "Game.h"
+#include "Profiler.h"
+#include "SearchScheduler.h"
+#include "Server.h"
+
+static Server *runningServer = nullptr;
+
+// Server::stop() only stores a flag and writes to a pipe, both safe here.
+static void stopServer(int) {
+  if (runningServer) { runningServer->stop(); }
+}
+
+auto main(int argc, char *argv[]) -> int {
+  auto launched = std::chrono::steady_clock::now();
+  bool startupTime = false;
+  std::string serverAddress;
+  int benchSessions = 0;
+  int benchSearches = 0;
+  int benchEvals = 0;
+  int profileSearches = 0;
+  std::vector<char *> args;
+
+  for (int i = 0; i < argc; i++) {
+    if (strncmp(argv[i], "--server=", 9) == 0) {
+      serverAddress = argv[i] + 9;
+    } else if (strncmp(argv[i], "--bench-server=", 15) == 0) {
+      benchSessions = atoi(argv[i] + 15);
+    } else if (strncmp(argv[i], "--bench-coroutines=", 19) == 0) {
+      benchSearches = atoi(argv[i] + 19);
+    } else if (strncmp(argv[i], "--bench-eval=", 13) == 0) {
+      benchEvals = atoi(argv[i] + 13);
+    } else if (strcmp(argv[i], "--startup-time") == 0) {
+      startupTime = true;
+    } else if (strncmp(argv[i], "--profile=", 10) == 0) {
+      profileSearches = atoi(argv[i] + 10);
+    } else {
+      args.push_back(argv[i]);
+    }
+  }
+
+  Options options;
+  options.load(CONFIG);
+  options.parseArgs((int) args.size(), args.data());
+
+  // The book and game records live next to the executable, wherever it
+  // is started from.
+  if (char *base = SDL_GetBasePath()) {
+    options.baseDir = base;
+    SDL_free(base);
+  }
+
+  // The GUI loads weights as it applies its options; everything else
+  // needs them in place before the first search.
+  bool headless = benchSessions > 0 || benchSearches > 0 || benchEvals > 0 || profileSearches > 0 || !serverAddress.empty();
+  if (headless && !options.evalWeights.empty() && !Board::loadWeights(options.evalWeights.c_str())) {
+    printf("Unable to load weights %s\n", options.evalWeights.c_str());
+    return EXIT_FAILURE;
+  }
 
-auto main() -> int {
-  Game *game = new Game("Reversi");
+  if (benchSessions > 0)
+    return Server::bench(options, benchSessions);
+
+  if (benchSearches > 0)
+    return SearchScheduler::bench(options, benchSearches);
+
+  if (benchEvals > 0)
+    return Bench::evaluation(options, benchEvals);
+
+  if (profileSearches > 0) {
+#ifdef PROFILE
+    return Profiler::bench(options, profileSearches);
+#else
+    printf("--profile needs a build configured with -DREVERSI_PROFILE=ON\n");
+    return EXIT_FAILURE;
+#endif
+  }
+
+  if (!serverAddress.empty()) {
+    // Loaded regardless of useBook so "setoption book on" takes effect.
+    Book book;
+    book.load(options.dataPath(BOOK).c_str());
+
+    Server server(options, &book);
+    if (!server.listen(serverAddress)) { return EXIT_FAILURE; }
+
+    // A clean exit runs ~Server, which writes out the cache's last batch.
+    runningServer = &server;
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+
+    server.run();
+    runningServer = nullptr;
+    return EXIT_SUCCESS;
+  }
+
+  Game *game = new Game("Reversi", options);
+
+  if (startupTime) {
+    auto ready = std::chrono::steady_clock::now();
+    printf("first frame: %.1f ms\n", std::chrono::duration<double, std::milli>(game->firstFrame - launched).count());
+    printf("ready:       %.1f ms\n", std::chrono::duration<double, std::milli>(ready - launched).count());
+    game->clean();
+  }
 
   game->render();
 
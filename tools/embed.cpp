@@ -0,0 +1,144 @@
+// Build-time asset packer. Usage: embed <output.cpp> name=path ...
+//
+// BMP files are decoded to top-down ARGB8888 pixels, the format the
+// renderer uploads directly, so nothing is parsed at run time. Every
+// asset is deflated and written out as a byte array in an Asset table.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "Assets.h"
+
+static uint32_t read32(const std::vector<uint8_t> &d, size_t at) {
+  return d[at] | d[at + 1] << 8 | d[at + 2] << 16 | (uint32_t) d[at + 3] << 24;
+}
+
+static uint8_t channel(uint32_t pixel, uint32_t mask) {
+  if (!mask) { return 0xff; }
+  return (uint8_t) ((pixel & mask) >> __builtin_ctz(mask));
+}
+
+static bool decodeBmp(const std::vector<uint8_t> &d, std::vector<uint8_t> &out, int *width, int *height, uint32_t *flags) {
+  if (d.size() < 54 || d[0] != 'B' || d[1] != 'M') { return false; }
+
+  uint32_t offset = read32(d, 10);
+  uint32_t headerSize = read32(d, 14);
+  int w = (int) read32(d, 18);
+  int h = (int) read32(d, 22);
+  int bpp = d[28] | d[29] << 8;
+  uint32_t compression = read32(d, 30);
+  bool bottomUp = h > 0;
+  if (h < 0) { h = -h; }
+
+  uint32_t masks[4] = {0xff0000, 0xff00, 0xff, 0};
+  if (compression == 3 && headerSize >= 56) {
+    for (int i = 0; i < 4; i++)
+      masks[i] = read32(d, 54 + i * 4);
+  } else if (compression != 0 || (bpp != 24 && bpp != 32)) {
+    return false;
+  }
+
+  size_t stride = ((size_t) w * bpp / 8 + 3) & ~(size_t) 3;
+  if (offset + stride * h > d.size()) { return false; }
+
+  out.resize((size_t) w * h * 4);
+  *flags = masks[3] ? ASSET_ALPHA : 0;
+
+  for (int y = 0; y < h; y++) {
+    const uint8_t *row = &d[offset + stride * (bottomUp ? h - 1 - y : y)];
+
+    for (int x = 0; x < w; x++) {
+      uint32_t pixel;
+      if (bpp == 24) {
+        pixel = row[x * 3] | row[x * 3 + 1] << 8 | row[x * 3 + 2] << 16;
+      } else {
+        pixel = row[x * 4] | row[x * 4 + 1] << 8 | row[x * 4 + 2] << 16 | (uint32_t) row[x * 4 + 3] << 24;
+      }
+
+      uint8_t *argb = &out[((size_t) y * w + x) * 4];
+      argb[0] = channel(pixel, masks[2]);
+      argb[1] = channel(pixel, masks[1]);
+      argb[2] = channel(pixel, masks[0]);
+      argb[3] = channel(pixel, masks[3]);
+    }
+  }
+
+  *width = w;
+  *height = h;
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("usage: %s <output.cpp> name=path ...\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  std::string body;
+  std::string table;
+
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    auto eq = arg.find('=');
+    if (eq == std::string::npos) {
+      printf("Invalid asset %s\n", argv[i]);
+      return EXIT_FAILURE;
+    }
+
+    std::string name = arg.substr(0, eq);
+    std::string path = arg.substr(eq + 1);
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+      printf("Unable to read %s\n", path.c_str());
+      return EXIT_FAILURE;
+    }
+
+    std::vector<uint8_t> raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<uint8_t> data;
+    int width = 0, height = 0;
+    uint32_t flags = 0;
+
+    if (path.size() > 4 && path.compare(path.size() - 4, 4, ".bmp") == 0) {
+      if (!decodeBmp(raw, data, &width, &height, &flags)) {
+        printf("Unsupported bitmap %s\n", path.c_str());
+        return EXIT_FAILURE;
+      }
+    } else {
+      data = raw;
+    }
+
+    uLongf packedSize = compressBound((uLong) data.size());
+    std::vector<uint8_t> packed(packedSize);
+    if (compress2(packed.data(), &packedSize, data.data(), (uLong) data.size(), Z_BEST_COMPRESSION) != Z_OK) {
+      printf("Unable to compress %s\n", path.c_str());
+      return EXIT_FAILURE;
+    }
+
+    std::string symbol = "asset" + std::to_string(i - 2);
+    body += "static const unsigned char " + symbol + "[] = {";
+    for (uLongf b = 0; b < packedSize; b++) {
+      if (b % 24 == 0) { body += "\n  "; }
+      body += std::to_string(packed[b]) + ",";
+    }
+    body += "\n};\n\n";
+
+    table += "    {\"" + name + "\", " + std::to_string(width) + ", " + std::to_string(height) + ", " +
+             std::to_string(flags) + ", " + std::to_string(data.size()) + ", " + symbol + ", sizeof(" + symbol + ")},\n";
+
+    printf("embed %s: %zu -> %lu bytes\n", name.c_str(), raw.size(), (unsigned long) packedSize);
+  }
+
+  std::ofstream out(argv[1]);
+  out << "// Generated by tools/embed.cpp, do not edit.\n\n#include \"Assets.h\"\n\n" << body;
+  out << "const Asset Assets::table[] = {\n" << table << "};\n\n";
+  out << "const int Assets::count = " << argc - 2 << ";\n";
+
+  return out.good() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,165 @@
+// Record format and symmetry regression check: round-trips GameRecord
+// through a file and checks that every board symmetry gives the same
+// canonical position and key, and that inverse() undoes it.
+// Usage: recordcheck [positions per size]
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#include "Board.h"
+#include "GameRecord.h"
+#include "Position.h"
+
+#define CHECK_POSITIONS 200
+#define CHECK_FILE "recordcheck.rgr"
+
+static int failures = 0;
+
+static void expect(bool ok, const char *what) {
+  if (ok) { return; }
+  printf("failed: %s\n", what);
+  failures++;
+}
+
+static std::vector<RecordView> readBack(const GameRecordFile &file) {
+  std::vector<RecordView> views;
+  for (auto record : file)
+    views.push_back(record);
+  return views;
+}
+
+static void checkRecords() {
+  GameRecord plain;
+  plain.addMove(Move(3, 2));
+  plain.addMove(Move(2, 2));
+  plain.addMove(Move(1, 2));
+  plain.setResult(-12);
+
+  GameRecord evals;
+  evals.addMove(Move(3, 2), 150);
+  evals.addMove(Move(2, 2), -40000);
+  evals.addMove(Move(1, 2), 40000);
+  evals.setResult(64);
+
+  GameRecord empty;
+
+  GameRecord offBoard;
+  offBoard.addMove(Move(3, 2));
+  offBoard.addMove(Move(0, SIZE));
+
+  {
+    std::ofstream out(CHECK_FILE, std::ios::binary | std::ios::trunc);
+    plain.write(out);
+    evals.write(out);
+    empty.write(out);
+    offBoard.write(out);
+    plain.write(out);
+  }
+
+  std::ifstream in(CHECK_FILE, std::ios::binary | std::ios::ate);
+  size_t expectedSize = RecordView::size(*plain.view().header) * 2 + RecordView::size(*evals.view().header) +
+                        RecordView::size(*empty.view().header) + RecordView::size(*offBoard.view().header);
+  expect((size_t) in.tellg() == expectedSize, "file size matches RecordView::size");
+  expect(RecordView::size(*plain.view().header) == sizeof(RecordHeader) + 4, "odd move count padded to even");
+  expect(RecordView::size(*evals.view().header) == sizeof(RecordHeader) + 4 + 3 * sizeof(int16_t), "evals follow padding");
+
+  {
+    GameRecordFile file(CHECK_FILE);
+    expect(file.isOpen(), "file opens");
+
+    auto views = readBack(file);
+    expect(views.size() == 3, "iteration stops at the off-board square");
+
+    if (views.size() == 3) {
+      expect(views[0].moveCount() == 3 && !views[0].hasEvals(), "plain header");
+      expect(views[0].header->result == -12, "plain result");
+      expect(views[0].move(0).col == 3 && views[0].move(0).row == 2, "plain first move");
+      expect(views[0].move(2).col == 1 && views[0].move(2).row == 2, "plain last move");
+      expect(views[0].moves[3] == 0, "padding byte is zero");
+
+      expect(views[1].moveCount() == 3 && views[1].hasEvals(), "evals header");
+      expect(views[1].header->result == 64, "evals result");
+      expect(views[1].eval(0) == 150, "eval kept");
+      expect(views[1].eval(1) == -32768 && views[1].eval(2) == 32767, "evals clamped to int16");
+      expect(views[1].move(1).col == 2 && views[1].move(1).row == 2, "evals move");
+
+      expect(views[2].moveCount() == 0 && views[2].header->result == 0, "empty record");
+    }
+  }
+
+  {
+    std::ofstream out(CHECK_FILE, std::ios::binary | std::ios::trunc);
+    plain.write(out);
+    out.write("VR", 2);
+  }
+
+  {
+    GameRecordFile file(CHECK_FILE);
+    expect(readBack(file).size() == 1, "iteration stops at a truncated record");
+  }
+
+  std::remove(CHECK_FILE);
+  printf("records: %d failures\n", failures);
+}
+
+template<int N>
+static int checkSymmetries(int positions) {
+  int before = failures;
+
+  for (int square = 0; square < N * N; square++)
+    for (int s = 0; s < SYMMETRIES; s++) {
+      int inv = BasicPosition<N>::inverse(s);
+      expect(BasicPosition<N>::transformSquare(BasicPosition<N>::transformSquare(square, s), inv) == square,
+             "inverse maps a square back");
+    }
+
+  for (int i = 0; i < positions; i++) {
+    int color;
+    auto position = BasicPosition<N>::random((unsigned) i + 1, i % (N * N - 4), &color);
+
+    int symmetry;
+    auto canonical = position.canonical(&symmetry);
+    uint64_t key = position.key(color);
+    expect(position.transformed(symmetry) == canonical, "canonical is the reported transform");
+
+    for (int s = 0; s < SYMMETRIES; s++) {
+      auto t = position.transformed(s);
+      expect(t.canonical(nullptr) == canonical, "canonical is the same for every transform");
+      expect(t.key(color) == key, "key is the same for every transform");
+      expect(t.transformed(BasicPosition<N>::inverse(s)) == position, "inverse maps a position back");
+      expect(t.legalMoves(color) == BasicPosition<N>::transform(position.legalMoves(color), s),
+             "legal moves follow the transform");
+
+      int ts;
+      t.key(color, &ts);
+      auto moves = position.legalMoves(color);
+      while (moves) {
+        int square = position.firstSquare(moves);
+        moves &= moves - 1;
+
+        int inCanonical = BasicPosition<N>::transformSquare(BasicPosition<N>::transformSquare(square, s), ts);
+        expect(BasicPosition<N>::transformSquare(inCanonical, BasicPosition<N>::inverse(ts)) ==
+               BasicPosition<N>::transformSquare(square, s), "move maps back from canonical coordinates");
+      }
+    }
+
+    if (position.legalMoves(color))
+      expect(position.key(color) != position.key(color == DARK ? LIGHT : DARK), "side to move changes the key");
+  }
+
+  printf("%dx%d: %d positions, %d failures\n", N, N, positions, failures - before);
+  return failures - before;
+}
+
+int main(int argc, char *argv[]) {
+  int positions = argc > 1 ? atoi(argv[1]) : CHECK_POSITIONS;
+
+  checkRecords();
+  checkSymmetries<6>(positions);
+  checkSymmetries<8>(positions);
+  checkSymmetries<10>(positions);
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,72 @@
+// Endgame regression check: solves random late positions on every board
+// size with BasicEndgame and compares against plain minimax over the
+// whole game tree. Usage: solvecheck [positions per size]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Endgame.h"
+#include "Position.h"
+
+#define CHECK_POSITIONS 20
+#define CHECK_EMPTIES 9
+
+template<int N>
+static int bruteForce(const BasicPosition<N> &position, int color) {
+  int other = color == DARK ? LIGHT : DARK;
+  auto moves = position.legalMoves(color);
+
+  if (!moves) {
+    if (!position.legalMoves(other))
+      return BasicEndgame<N>::finalScore(position, color);
+    return -bruteForce(position, other);
+  }
+
+  int best = -N * N;
+
+  while (moves) {
+    int square = position.firstSquare(moves);
+    moves &= moves - 1;
+
+    BasicPosition<N> child = position;
+    child.play(square, color);
+    best = std::max(best, -bruteForce(child, other));
+  }
+
+  return best;
+}
+
+// Besides the exact score, a null window either side of it must fail
+// the right way.
+template<int N>
+static int check(int positions) {
+  int failures = 0;
+  int checked = 0;
+
+  for (unsigned seed = 1; checked < positions; seed++) {
+    int color;
+    auto position = BasicPosition<N>::random(seed, N * N - 4 - CHECK_EMPTIES, &color);
+    if (position.empties() != CHECK_EMPTIES || !position.legalMoves(color)) { continue; }
+    checked++;
+
+    int expected = bruteForce(position, color);
+    int exact = BasicEndgame<N>::solve(position, color, -N * N, N * N);
+    int high = BasicEndgame<N>::solve(position, color, expected, expected + 1);
+    int low = BasicEndgame<N>::solve(position, color, expected - 1, expected);
+
+    if (exact != expected || high > expected || low < expected) {
+      printf("%dx%d seed %u: expected %d, solve %d, above %d, below %d\n", N, N, seed, expected, exact, high, low);
+      failures++;
+    }
+  }
+
+  printf("%dx%d: %d positions, %d failures\n", N, N, checked, failures);
+  return failures;
+}
+
+int main(int argc, char *argv[]) {
+  int positions = argc > 1 ? atoi(argv[1]) : CHECK_POSITIONS;
+  int failures = check<6>(positions) + check<8>(positions) + check<10>(positions);
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}